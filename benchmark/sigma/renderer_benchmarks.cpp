@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <sigma/context.hpp>
+#include <sigma/graphics/frame_capture.hpp>
+#include <sigma/graphics/null_renderer.hpp>
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+// A scene of a few hundred mesh and material combinations drawn many times.
+void record_scene(sigma::graphics::render_queue* queue, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const std::uint32_t mesh = i % 256;
+        const std::uint32_t material = i % 32;
+        auto cmd = queue->enqueue(sigma::graphics::make_sort_key(0, i % 4, material, mesh, float(i % 1000) / 1000.0f));
+        cmd->program = i % 4;
+        cmd->mesh = mesh;
+        cmd->count = 36;
+        cmd->input_textures[0] = material;
+        cmd->model = sigma::affine::compose({ float(i), 0, 0 }, {}, glm::vec3 { 1 });
+    }
+}
+}
+
+static void null_renderer_frame(benchmark::State& st)
+{
+    auto ctx = std::make_shared<sigma::context>(".");
+    sigma::graphics::null_renderer renderer { { 1280, 720 }, ctx };
+
+    while (st.KeepRunning()) {
+        st.PauseTiming();
+        ctx->render_memory().begin_frame();
+        record_scene(renderer.queue(), st.range(0));
+        st.ResumeTiming();
+
+        renderer.render();
+    }
+    st.counters["sort_ns"] = double(renderer.timings().sort.count());
+    st.counters["state_ns"] = double(renderer.timings().state.count());
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+// Replays the frame captured in the file named by SIGMA_FRAME_CAPTURE, or a
+// synthetic frame when it is not set.
+static void null_renderer_replay(benchmark::State& st)
+{
+    sigma::graphics::frame_capture capture;
+    if (const char* path = std::getenv("SIGMA_FRAME_CAPTURE")) {
+        capture = sigma::graphics::frame_capture::load(path);
+    } else {
+        sigma::graphics::render_queue queue { 0 };
+        record_scene(&queue, 1 << 14);
+        capture = sigma::graphics::frame_capture::capture(queue, { { 1280, 720 }, {} });
+    }
+
+    auto ctx = std::make_shared<sigma::context>(".");
+    sigma::graphics::null_renderer renderer { capture.size, ctx };
+    while (st.KeepRunning()) {
+        st.PauseTiming();
+        ctx->render_memory().begin_frame();
+        capture.replay(renderer);
+        st.ResumeTiming();
+
+        renderer.render();
+    }
+    st.SetItemsProcessed(st.iterations() * capture.commands.size());
+}
+
+BENCHMARK(null_renderer_frame)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK(null_renderer_replay);
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <sigma/transform.hpp>
+#include <sigma/transform_store.hpp>
+
+#include <vector>
+
+namespace {
+sigma::transform make_transform(int i)
+{
+    return { glm::vec3 { float(i), 1.0f, 2.0f }, glm::angleAxis(float(i) * 0.001f, glm::vec3 { 0, 1, 0 }), glm::vec3 { 1.0f + float(i % 3) } };
+}
+}
+
+static void transform_get_matrix(benchmark::State& st)
+{
+    std::vector<sigma::transform> transforms;
+    for (int i = 0; i < st.range(0); ++i)
+        transforms.push_back(make_transform(i));
+    std::vector<glm::mat4> matrices(transforms.size());
+
+    while (st.KeepRunning()) {
+        for (std::size_t i = 0; i < transforms.size(); ++i)
+            matrices[i] = transforms[i].get_matrix();
+#ifndef _MSC_VER
+        benchmark::ClobberMemory();
+#endif
+    }
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+static void transform_get_affine(benchmark::State& st)
+{
+    std::vector<sigma::transform> transforms;
+    for (int i = 0; i < st.range(0); ++i)
+        transforms.push_back(make_transform(i));
+
+    while (st.KeepRunning()) {
+        for (auto& t : transforms)
+            t.matrix = t.get_affine();
+#ifndef _MSC_VER
+        benchmark::ClobberMemory();
+#endif
+    }
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+static void transform_store_compose(benchmark::State& st)
+{
+    sigma::transform_store store;
+    for (int i = 0; i < st.range(0); ++i)
+        store.insert(static_cast<sigma::transform_store::entity_type>(i), make_transform(i));
+    std::vector<sigma::affine::matrix> matrices(store.size());
+
+    while (st.KeepRunning()) {
+        sigma::transform_store::compose(store.data(), store.size(), matrices.data());
+#ifndef _MSC_VER
+        benchmark::ClobberMemory();
+#endif
+    }
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+static void transform_store_compose_parallel(benchmark::State& st)
+{
+    sigma::transform_store store;
+    for (int i = 0; i < st.range(0); ++i)
+        store.insert(static_cast<sigma::transform_store::entity_type>(i), make_transform(i));
+
+    while (st.KeepRunning()) {
+        store.compose();
+#ifndef _MSC_VER
+        benchmark::ClobberMemory();
+#endif
+    }
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+BENCHMARK(transform_get_matrix)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(transform_get_affine)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(transform_store_compose)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(transform_store_compose_parallel)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
@@ -1,8 +1,12 @@
 #ifndef SIGMA_AABB_HPP
 #define SIGMA_AABB_HPP
 
+#include <sigma/util/glm_serialize.hpp>
+
 #include <glm/vec3.hpp>
 
+#include <cassert>
+
 #include <limits>
 
 namespace sigma {
@@ -37,6 +41,16 @@ public:
         return half_size_ * 2.0f;
     }
 
+    glm::vec3 min() const noexcept
+    {
+        return min_;
+    }
+
+    glm::vec3 max() const noexcept
+    {
+        return max_;
+    }
+
     AABB minkowski_difference(const AABB& other) const noexcept
     {
         glm::vec3 tl = min_ - other.max_;
@@ -78,10 +92,9 @@ public:
         return output;
     }
 
-    bool collides(const AABB& other) const
+    bool collides(const AABB& other) const noexcept
     {
-        AABB diff = minkowski_difference(other);
-        return diff.contains({ 0, 0, 0 });
+        return (min_.x <= other.max_.x && other.min_.x <= max_.x) && (min_.y <= other.max_.y && other.min_.y <= max_.y) && (min_.z <= other.max_.z && other.min_.z <= max_.z);
     }
 
     bool collides(const AABB& other, glm::vec3& penetration) const
@@ -94,6 +107,13 @@ public:
         return false;
     }
 
+    template <class Archive>
+    void serialize(Archive& ar)
+    {
+        ar(center_, half_size_);
+        recalculate();
+    }
+
 private:
     void recalculate()
     {
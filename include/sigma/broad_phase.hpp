@@ -0,0 +1,125 @@
+#ifndef SIGMA_BROAD_PHASE_HPP
+#define SIGMA_BROAD_PHASE_HPP
+
+#include <sigma/AABB.hpp>
+#include <sigma/config.hpp>
+
+#include <entt/entt.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sigma {
+// Sort and sweep broad phase. Bounds are kept sorted by their minimum on
+// the sweep axis between updates, objects move little from frame to frame
+// so an insertion sort brings the order back in close to linear time. The
+// sweep then only tests the other two axes for objects whose intervals
+// overlap on the sweep axis.
+//
+// The overlapping pairs are kept from one sweep to the next so the pairs
+// that started and stopped overlapping can be reported as events.
+class broad_phase {
+public:
+    using id_type = entt::registry<>::entity_type;
+
+    enum class axis {
+        x,
+        y,
+        z,
+        // Sweeps the axis along which the objects are spread the most.
+        automatic
+    };
+
+    struct pair {
+        id_type first;
+        id_type second;
+
+        bool operator==(const pair& other) const noexcept
+        {
+            return first == other.first && second == other.second;
+        }
+    };
+
+    broad_phase(axis sweep_axis = axis::automatic);
+
+    broad_phase(broad_phase&&) = default;
+
+    broad_phase& operator=(broad_phase&&) = default;
+
+    std::size_t size() const noexcept;
+
+    bool contains(id_type id) const noexcept;
+
+    void insert(id_type id, const AABB& bounds);
+
+    void insert(id_type id, const glm::vec3& min, const glm::vec3& max);
+
+    void update(id_type id, const AABB& bounds);
+
+    void update(id_type id, const glm::vec3& min, const glm::vec3& max);
+
+    void remove(id_type id);
+
+    void clear();
+
+    // Finds every overlapping pair and the pairs that started or stopped
+    // overlapping since the previous sweep. Pairs are ordered with the
+    // smaller id first and the lists are sorted.
+    void sweep();
+
+    // Inserts, updates and removes the entities with an AABB component
+    // then sweeps.
+    void update(entt::registry<>& registry);
+
+    const std::vector<pair>& pairs() const noexcept;
+
+    const std::vector<pair>& begin_events() const noexcept;
+
+    const std::vector<pair>& end_events() const noexcept;
+
+private:
+    broad_phase(const broad_phase&) = delete;
+
+    broad_phase& operator=(const broad_phase&) = delete;
+
+    axis requested_axis_;
+    std::size_t sweep_axis_;
+    std::size_t size_ = 0;
+    std::uint64_t stamp_ = 0;
+
+    // Per slot state.
+    std::array<std::vector<float>, 3> min_;
+    std::array<std::vector<float>, 3> max_;
+    std::vector<id_type> ids_;
+    std::vector<bool> alive_;
+    std::vector<std::uint64_t> stamps_;
+    std::vector<std::uint32_t> free_;
+    std::unordered_map<id_type, std::uint32_t> slots_;
+
+    // Slots sorted by their minimum on the sweep axis and the bounds
+    // gathered in that order.
+    std::vector<std::uint32_t> order_;
+    std::array<std::vector<float>, 3> sorted_min_;
+    std::array<std::vector<float>, 3> sorted_max_;
+
+    std::vector<std::uint64_t> pair_keys_;
+    std::vector<std::uint64_t> previous_keys_;
+    std::vector<pair> pairs_;
+    std::vector<pair> begin_events_;
+    std::vector<pair> end_events_;
+
+    void choose_axis_();
+
+    void sort_();
+
+    static std::uint64_t key_(id_type a, id_type b) noexcept;
+
+    static pair unpack_(std::uint64_t key) noexcept;
+};
+}
+
+#endif // SIGMA_BROAD_PHASE_HPP
@@ -0,0 +1,232 @@
+#ifndef SIGMA_BVH_HPP
+#define SIGMA_BVH_HPP
+
+#include <sigma/AABB.hpp>
+#include <sigma/config.hpp>
+#include <sigma/frustum.hpp>
+#include <sigma/util/glm_serialize.hpp>
+
+#include <cereal/types/vector.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace sigma {
+// Bounding volume hierarchy over a set of primitive bounds, built with
+// binned SAH. Primitives are referenced by their index in the array passed
+// to build. Moving primitives are handled with update and refit, once the
+// tree has degraded past rebuild_ratio needs_rebuild will return true.
+class bvh {
+public:
+    static constexpr std::uint32_t MAX_DEPTH = 64;
+
+    struct node {
+        glm::vec3 min;
+        // The left child for internal nodes (the right child is first + 1)
+        // or the first entry of indices for leaves.
+        std::uint32_t first;
+        glm::vec3 max;
+        // Zero for internal nodes.
+        std::uint32_t count;
+
+        bool is_leaf() const noexcept
+        {
+            return count != 0;
+        }
+
+        template <class Archive>
+        void serialize(Archive& ar)
+        {
+            ar(min, first, max, count);
+        }
+    };
+
+    bvh() = default;
+
+    bvh(bvh&&) = default;
+
+    bvh& operator=(bvh&&) = default;
+
+    void build(const std::vector<AABB>& bounds);
+
+    void build(const std::vector<glm::vec3>& min, const std::vector<glm::vec3>& max);
+
+    void update(std::uint32_t primitive, const AABB& bounds);
+
+    void update(std::uint32_t primitive, const glm::vec3& min, const glm::vec3& max);
+
+    void refit();
+
+    std::size_t size() const noexcept;
+
+    bool empty() const noexcept;
+
+    const std::vector<node>& nodes() const noexcept;
+
+    const std::vector<std::uint32_t>& indices() const noexcept;
+
+    const glm::vec3& min(std::uint32_t primitive) const noexcept;
+
+    const glm::vec3& max(std::uint32_t primitive) const noexcept;
+
+    float cost() const noexcept;
+
+    float build_cost() const noexcept;
+
+    float rebuild_ratio() const noexcept;
+
+    void set_rebuild_ratio(float ratio) noexcept;
+
+    bool needs_rebuild() const noexcept;
+
+    // Generic depth first traversal. test(const node&, std::uint64_t& mask)
+    // returns false to cull the node and may clear bits of mask that are
+    // passed down to the children, visit(std::uint32_t primitive, std::uint64_t mask)
+    // is called for each primitive in a leaf that passed test.
+    template <class Test, class Visit>
+    void traverse(std::uint64_t mask, Test&& test, Visit&& visit) const
+    {
+        if (nodes_.empty())
+            return;
+
+        std::pair<std::uint32_t, std::uint64_t> stack[MAX_DEPTH + 1];
+        std::size_t top = 0;
+        stack[top++] = { 0, mask };
+        while (top > 0) {
+            auto [index, node_mask] = stack[--top];
+            const auto& n = nodes_[index];
+            if (!test(n, node_mask))
+                continue;
+
+            if (n.is_leaf()) {
+                for (std::uint32_t i = n.first; i < n.first + n.count; ++i)
+                    visit(indices_[i], node_mask);
+            } else {
+                stack[top++] = { n.first + 1, node_mask };
+                stack[top++] = { n.first, node_mask };
+            }
+        }
+    }
+
+    template <class F>
+    void query(const glm::vec3& min, const glm::vec3& max, F&& f) const
+    {
+        traverse(0,
+            [&](const node& n, std::uint64_t&) {
+                return overlaps(n.min, n.max, min, max);
+            },
+            [&](std::uint32_t primitive, std::uint64_t) {
+                if (overlaps(min_[primitive], max_[primitive], min, max))
+                    f(primitive);
+            });
+    }
+
+    template <class F>
+    void query(const AABB& box, F&& f) const
+    {
+        query(box.min(), box.max(), std::forward<F>(f));
+    }
+
+    // Calls f for every primitive whose bounds intersect the frustum. Planes
+    // a node is fully inside of are not tested again for its children.
+    template <class F>
+    void query(const frustum& view, F&& f) const
+    {
+        const auto& planes = view.planes();
+        traverse((1 << planes.size()) - 1,
+            [&](const node& n, std::uint64_t& mask) {
+                return test_planes(planes, n.min, n.max, mask);
+            },
+            [&](std::uint32_t primitive, std::uint64_t mask) {
+                if (test_planes(planes, min_[primitive], max_[primitive], mask))
+                    f(primitive);
+            });
+    }
+
+    // Calls f(primitive, max_distance) for every primitive whose bounds are
+    // hit by the ray before max_distance. f may shrink max_distance to only
+    // search for closer hits (or set it to zero to stop the search).
+    template <class F>
+    void raycast(const glm::vec3& origin, const glm::vec3& direction, float& max_distance, F&& f) const
+    {
+        const glm::vec3 inv_direction = 1.0f / direction;
+        traverse(0,
+            [&](const node& n, std::uint64_t&) {
+                return intersects(origin, inv_direction, max_distance, n.min, n.max);
+            },
+            [&](std::uint32_t primitive, std::uint64_t) {
+                if (intersects(origin, inv_direction, max_distance, min_[primitive], max_[primitive]))
+                    f(primitive, max_distance);
+            });
+    }
+
+    template <class Archive>
+    void serialize(Archive& ar)
+    {
+        ar(nodes_, parents_, indices_, leaves_, min_, max_, area_sum_, build_cost_, rebuild_ratio_);
+    }
+
+    static bool overlaps(const glm::vec3& a_min, const glm::vec3& a_max, const glm::vec3& b_min, const glm::vec3& b_max) noexcept
+    {
+        return a_min.x <= b_max.x && b_min.x <= a_max.x
+            && a_min.y <= b_max.y && b_min.y <= a_max.y
+            && a_min.z <= b_max.z && b_min.z <= a_max.z;
+    }
+
+    static bool intersects(const glm::vec3& origin, const glm::vec3& inv_direction, float max_distance, const glm::vec3& min, const glm::vec3& max) noexcept
+    {
+        glm::vec3 t0 = (min - origin) * inv_direction;
+        glm::vec3 t1 = (max - origin) * inv_direction;
+        glm::vec3 t_near = glm::min(t0, t1);
+        glm::vec3 t_far = glm::max(t0, t1);
+        float enter = std::max(std::max(t_near.x, t_near.y), std::max(t_near.z, 0.0f));
+        float exit = std::min(std::min(t_far.x, t_far.y), std::min(t_far.z, max_distance));
+        return enter <= exit;
+    }
+
+    template <std::size_t N>
+    static bool test_planes(const std::array<glm::vec4, N>& planes, const glm::vec3& min, const glm::vec3& max, std::uint64_t& mask) noexcept
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            if ((mask & (std::uint64_t(1) << i)) == 0)
+                continue;
+
+            const auto& plane = planes[i];
+            glm::vec3 normal { plane };
+            glm::vec3 p { normal.x >= 0 ? max.x : min.x, normal.y >= 0 ? max.y : min.y, normal.z >= 0 ? max.z : min.z };
+            if (glm::dot(normal, p) + plane.w < 0)
+                return false;
+
+            glm::vec3 n { normal.x >= 0 ? min.x : max.x, normal.y >= 0 ? min.y : max.y, normal.z >= 0 ? min.z : max.z };
+            if (glm::dot(normal, n) + plane.w >= 0)
+                mask &= ~(std::uint64_t(1) << i);
+        }
+        return true;
+    }
+
+private:
+    bvh(const bvh&) = delete;
+
+    bvh& operator=(const bvh&) = delete;
+
+    std::vector<node> nodes_;
+    std::vector<std::uint32_t> parents_;
+    std::vector<std::uint32_t> indices_;
+    std::vector<std::uint32_t> leaves_;
+    std::vector<glm::vec3> min_;
+    std::vector<glm::vec3> max_;
+    std::vector<std::uint32_t> dirty_;
+    double area_sum_ = 0;
+    float build_cost_ = 0;
+    float rebuild_ratio_ = 1.5f;
+
+    float node_weight_(const node& n) const noexcept;
+};
+}
+
+#endif // SIGMA_BVH_HPP
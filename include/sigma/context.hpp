@@ -1,6 +1,8 @@
 #ifndef SIGMA_CONTEXT_HPP
 #define SIGMA_CONTEXT_HPP
 
+#include <sigma/frame_allocator.hpp>
+
 #include <filesystem>
 #include <memory>
 #include <typeindex>
@@ -25,6 +27,15 @@ public:
 
     const std::filesystem::path& cache_path() const;
 
+    // Per-frame memory of the game thread with one sub-arena for each
+    // worker. The game loop calls begin_frame() on it once per frame.
+    frame_allocator& frame_memory();
+
+    // Per-frame memory of the render thread, separate from frame_memory()
+    // so the two threads never share a sub-arena. Advanced by whoever drives
+    // rendering, e.g. the render_pipeline, renderers only allocate from it.
+    frame_allocator& render_memory();
+
     template <class U>
     inline std::shared_ptr<resource::cache<U>> cache()
     {
@@ -43,6 +54,8 @@ private:
 
     std::filesystem::path cache_path_;
     std::unordered_map<std::type_index, std::shared_ptr<resource::base_cache>> caches_;
+    frame_allocator frame_memory_;
+    frame_allocator render_memory_;
 };
 }
 
@@ -0,0 +1,139 @@
+#ifndef SIGMA_FRAME_ALLOCATOR_HPP
+#define SIGMA_FRAME_ALLOCATOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace sigma {
+// Bump pointer memory for data that only lives for one frame. There is an
+// arena for each frame in flight, each split into per-thread sub-arenas so
+// workers can allocate without synchronizing. Nothing is freed on its own,
+// begin_frame() resets the arena of the frame that retired FRAME_COUNT
+// frames ago.
+//
+// When a sub-arena runs out another block is chained to it and on the next
+// reset the blocks are replaced by one block large enough for all of them,
+// so after a few frames every allocation is a pointer increment.
+class frame_allocator {
+public:
+    static constexpr std::size_t FRAME_COUNT = 3;
+
+    frame_allocator(std::size_t block_size = 1 << 20, std::size_t thread_count = 1);
+
+    frame_allocator(frame_allocator&&) = default;
+
+    frame_allocator& operator=(frame_allocator&&) = default;
+
+    std::size_t thread_count() const noexcept;
+
+    std::uint64_t frame() const noexcept;
+
+    // Moves to the next frame and resets the arena it reuses. The caller has
+    // to make sure that frame is no longer read, e.g. by its GPU fence.
+    void begin_frame();
+
+    // Only one thread at a time may use a given thread index.
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t), std::size_t thread = 0);
+
+    template <class T>
+    T* allocate(std::size_t count, std::size_t thread = 0)
+    {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T), thread));
+    }
+
+    // Bytes handed out for the current frame.
+    std::size_t used() const noexcept;
+
+private:
+    frame_allocator(const frame_allocator&) = delete;
+
+    frame_allocator& operator=(const frame_allocator&) = delete;
+
+    struct block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size;
+    };
+
+    // Aligned so sub-arenas used by different threads do not share a cache line.
+    struct alignas(64) sub_arena {
+        std::vector<block> blocks;
+        std::size_t offset = 0;
+        std::size_t used = 0;
+    };
+
+    std::size_t block_size_;
+    std::size_t thread_count_;
+    std::uint64_t frame_ = 0;
+    std::array<std::vector<sub_arena>, FRAME_COUNT> arenas_;
+
+    void reset_(sub_arena& arena);
+};
+
+// Standard allocator drawing from one sub-arena of a frame_allocator, for
+// containers that are thrown away at the end of the frame. Deallocation
+// does nothing. The allocator moves along with the container so a list
+// filled on a worker can be handed to another owner, a default constructed
+// allocator can not allocate.
+template <class T>
+class arena_allocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    arena_allocator() noexcept = default;
+
+    arena_allocator(frame_allocator& frames, std::size_t thread = 0) noexcept
+        : frames_(&frames)
+        , thread_(thread)
+    {
+    }
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) noexcept
+        : frames_(other.frames_)
+        , thread_(other.thread_)
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        if (!frames_)
+            throw std::bad_alloc();
+        return frames_->allocate<T>(count, thread_);
+    }
+
+    void deallocate(T*, std::size_t) noexcept
+    {
+    }
+
+    template <class U>
+    bool operator==(const arena_allocator<U>& other) const noexcept
+    {
+        return frames_ == other.frames_ && thread_ == other.thread_;
+    }
+
+    template <class U>
+    bool operator!=(const arena_allocator<U>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    template <class>
+    friend class arena_allocator;
+
+    frame_allocator* frames_ = nullptr;
+    std::size_t thread_ = 0;
+};
+
+template <class T>
+using frame_vector = std::vector<T, arena_allocator<T>>;
+}
+
+#endif // SIGMA_FRAME_ALLOCATOR_HPP
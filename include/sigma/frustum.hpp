@@ -1,20 +1,50 @@
 #ifndef SIGMA_GRAPHICS_FRUSTUM_HPP
 #define SIGMA_GRAPHICS_FRUSTUM_HPP
 
+#include <sigma/AABB.hpp>
 #include <sigma/config.hpp>
 
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
 #include <array>
+#include <vector>
 
 namespace sigma {
+enum class projection_type {
+    perspective,
+    orthographic
+};
+
+// Structure of arrays input for building many perspective frustums at once
+// (e.g. every spot light shadow each frame).
+struct perspective_batch {
+    std::vector<float> fovy;
+    std::vector<float> aspect;
+    std::vector<float> z_near;
+    std::vector<float> z_far;
+    std::vector<glm::mat4> view;
+
+    std::size_t size() const noexcept;
+
+    void clear() noexcept;
+
+    void push_back(float fovy, float aspect, float z_near, float z_far, const glm::mat4& view);
+};
+
+// Every setter recomputes the planes, the analytic inverse matrices, the
+// corners and the bounding sphere, so the const accessors never write and a
+// frustum can be read from several threads.
 class frustum {
 public:
     frustum();
 
     frustum(float fovy, float aspect, float z_near, float z_far, const glm::mat4& view = {});
 
+    frustum(float left, float right, float bottom, float top, float z_near, float z_far, const glm::mat4& view = {});
+
+    projection_type type() const;
+
     float fovy() const;
 
     float aspect() const;
@@ -37,6 +67,8 @@ public:
 
     void set_projection(float fovy, float aspect, float z_near, float z_far);
 
+    void set_orthographic(float left, float right, float bottom, float top, float z_near, float z_far);
+
     glm::mat4 projection_view() const;
 
     void set_projection_view(float fovy, float aspect, float z_near, float z_far, const glm::mat4& view);
@@ -55,28 +87,48 @@ public:
 
     const std::array<glm::vec4, 8>& corners() const;
 
+    const std::array<glm::vec4, 6>& planes() const;
+
     bool contains_sphere(const glm::vec3& center, float radius) const;
 
+    bool contains_box(const glm::vec3& min, const glm::vec3& max) const;
+
+    bool contains_box(const AABB& box) const;
+
+    static void build(const perspective_batch& batch, frustum* output);
+
+    static void build(const perspective_batch& batch, frustum* const* output);
+
 private:
+    projection_type type_;
     float fovy_;
     float aspect_;
     float z_near_;
     float z_far_;
-    float diagonal_;
-    float radius_;
-    glm::vec3 center_;
     glm::mat4 projection_;
     glm::mat4 view_;
     glm::mat4 projection_view_;
+    std::array<glm::vec4, 6> planes_;
+
+    float diagonal_;
+    float radius_;
+    glm::vec3 center_;
     glm::mat4 inverse_view_;
     glm::mat4 inverse_projection_;
     glm::mat4 inverse_projection_view_;
     std::array<glm::vec4, 8> corners_;
-    std::array<glm::vec4, 6> planes_;
 
     glm::mat4 light_projection_(const glm::mat4& light_projection_view_matrix, float& minZ, float& maxZ, bool updateZ) const;
 
+    void assign_perspective_(float fovy, float aspect, float z_near, float z_far, const glm::mat4& view, const glm::mat4& projection);
+
+    void set_perspective_(float fovy, float aspect, float z_near, float z_far);
+
     void rebuild_();
+
+    void update_inverses_();
+
+    void update_corners_();
 };
 }
 
@@ -0,0 +1,85 @@
+#ifndef SIGMA_GRAPHICS_CASCADE_BUILDER_HPP
+#define SIGMA_GRAPHICS_CASCADE_BUILDER_HPP
+
+#include <sigma/AABB.hpp>
+#include <sigma/config.hpp>
+#include <sigma/frustum.hpp>
+#include <sigma/graphics/shadow_block.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // Fits directional light shadow cascades to a camera frustum.
+    //
+    // Each cascade is fitted to the bounding sphere of its slice of the
+    // camera frustum, so its size does not change when the camera rotates,
+    // and its origin is snapped to whole shadow map texels, so it does not
+    // shimmer when the camera moves. The light depth range of a cascade is
+    // clamped to the casters that overlap it.
+    //
+    // Cascades can be given an update interval, a cascade with an interval of
+    // N is only refitted (and needs its shadow map rendered) every Nth frame.
+    // Updates of different cascades are staggered so they do not all land on
+    // the same frame.
+    class cascade_builder {
+    public:
+        cascade_builder(std::size_t cascade_count = 3, std::uint32_t resolution = 2048);
+
+        std::size_t cascade_count() const noexcept;
+
+        void set_cascade_count(std::size_t count);
+
+        std::uint32_t resolution() const noexcept;
+
+        void set_resolution(std::uint32_t resolution);
+
+        // Blend between a linear (0) and a logarithmic (1) split scheme.
+        float split_lambda() const noexcept;
+
+        void set_split_lambda(float lambda);
+
+        std::uint32_t update_interval(std::size_t cascade) const;
+
+        void set_update_interval(std::size_t cascade, std::uint32_t frames);
+
+        // Forces every cascade to be refitted by the next update.
+        void invalidate() noexcept;
+
+        // Refits the cascades due on frame. light_direction is the direction
+        // the light travels in and casters holds the world bounds of every
+        // shadow caster that may fall inside the camera frustum.
+        void update(const frustum& camera, const glm::vec3& light_direction, const std::vector<AABB>& casters, std::uint64_t frame);
+
+        // Whether the cascade was refitted by the last update and its shadow
+        // map has to be rendered again.
+        bool needs_render(std::size_t cascade) const;
+
+        // View space distance of the far end of a cascade.
+        float split(std::size_t cascade) const;
+
+        const glm::mat4& projection_view(std::size_t cascade) const;
+
+        const shadow_block& block() const noexcept;
+
+    private:
+        std::size_t cascade_count_;
+        std::uint32_t resolution_;
+        float split_lambda_;
+        bool invalidated_;
+        std::array<std::uint32_t, MAX_SHADOW_CASCADES> intervals_;
+        std::array<bool, MAX_SHADOW_CASCADES> updated_;
+        std::array<float, MAX_SHADOW_CASCADES> splits_;
+        shadow_block block_;
+
+        void fit_(std::size_t cascade, const std::array<glm::vec3, 8>& corners, const glm::vec4& far_plane, const glm::mat4& light_view, const std::vector<glm::vec3>& caster_min, const std::vector<glm::vec3>& caster_max);
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_CASCADE_BUILDER_HPP
@@ -0,0 +1,94 @@
+#ifndef SIGMA_GRAPHICS_FRAME_CAPTURE_HPP
+#define SIGMA_GRAPHICS_FRAME_CAPTURE_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/graphics/render_queue.hpp>
+#include <sigma/graphics/renderer.hpp>
+#include <sigma/util/glm_serialize.hpp>
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // What a resource id in a render_command refers to, each kind has its
+    // own id space.
+    enum class resource_kind : std::uint8_t {
+        program,
+        buffer,
+        texture,
+        mesh
+    };
+
+    // Maps an id referenced by a command to its resource key, an empty key
+    // leaves the id out (e.g. for unbound slots).
+    using resource_resolver = std::function<std::string(resource_kind kind, std::uint64_t id)>;
+
+    // Keys of the resources behind the ids the commands reference, ids are
+    // only meaningful within the run that captured them.
+    struct resource_keys {
+        std::map<std::uint64_t, std::string> programs;
+        std::map<std::uint64_t, std::string> buffers;
+        std::map<std::uint64_t, std::string> textures;
+        std::map<std::uint64_t, std::string> meshes;
+
+        std::map<std::uint64_t, std::string>& of(resource_kind kind);
+
+        template <class Archive>
+        void serialize(Archive& ar)
+        {
+            ar(programs, buffers, textures, meshes);
+        }
+    };
+
+    // The workload of one frame: the view it was seen through and the
+    // render queue contents (view constants and commands in enqueue
+    // order). Replaying it through any renderer reproduces the CPU side of
+    // that frame.
+    struct frame_capture {
+        glm::ivec2 size;
+        glm::mat4 view;
+        glm::mat4 projection;
+        std::vector<std::uint64_t> keys;
+        std::vector<render_command> commands;
+        std::vector<standard_block> views;
+        resource_keys resources;
+
+        // Captures the queue, its buckets must have been merged. Every id
+        // the commands reference is looked up once with resolve, without a
+        // resolver no keys are recorded.
+        static frame_capture capture(const render_queue& queue, const view_port& view, const resource_resolver& resolve = {});
+
+        static frame_capture load(const std::filesystem::path& path);
+
+        void save(const std::filesystem::path& path) const;
+
+        // Adds the captured views and enqueues every captured command with
+        // its sort key, the queue should not hold any views yet.
+        void replay(render_queue& queue) const;
+
+        void replay(renderer& target) const;
+
+        template <class Archive>
+        void serialize(Archive& ar, const std::uint32_t version)
+        {
+            ar(size, view, projection, keys, commands, views, resources);
+        }
+    };
+}
+}
+
+CEREAL_CLASS_VERSION(sigma::graphics::frame_capture, 1);
+
+#endif // SIGMA_GRAPHICS_FRAME_CAPTURE_HPP
@@ -0,0 +1,150 @@
+#ifndef SIGMA_GRAPHICS_FRAME_GRAPH_HPP
+#define SIGMA_GRAPHICS_FRAME_GRAPH_HPP
+
+#include <sigma/config.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // Describes one frame as passes that declare the textures and buffers
+    // they read and write. compile() removes passes whose output is never
+    // used, derives the dependencies between the remaining passes and packs
+    // the transient resources into one heap, letting resources whose
+    // lifetimes do not overlap share memory.
+    //
+    // Dependencies follow declaration order: a pass depends on the earlier
+    // passes that wrote what it reads or read what it writes, so the passes
+    // run in the order they were added and anything the dependencies allow
+    // to run concurrently can be recorded in parallel. When two transient
+    // resources share heap memory the first pass using the later one also
+    // depends on every pass that used the earlier one, so aliased memory is
+    // never in use by two passes at once.
+    class frame_graph {
+    public:
+        using resource_handle = std::uint32_t;
+        using pass_handle = std::uint32_t;
+
+        // Placement alignment of transient resources in the heap.
+        static constexpr std::size_t ALIGNMENT = 64 * 1024;
+
+        static constexpr std::size_t NO_OFFSET = std::numeric_limits<std::size_t>::max();
+
+        class builder {
+        public:
+            resource_handle create_texture(const std::string& name, glm::ivec2 size, std::uint32_t bytes_per_pixel);
+
+            resource_handle create_buffer(const std::string& name, std::size_t size);
+
+            void read(resource_handle resource);
+
+            void write(resource_handle resource);
+
+            // The pass does something outside the graph (readback, present)
+            // and must never be culled.
+            void side_effect();
+
+        private:
+            friend class frame_graph;
+
+            builder(frame_graph& graph, pass_handle pass);
+
+            frame_graph& graph_;
+            pass_handle pass_;
+        };
+
+        using setup_function = std::function<void(builder&)>;
+        using execute_function = std::function<void(const frame_graph&)>;
+
+        // Resources owned outside the graph, like the back buffer. They are
+        // never aliased and passes writing them are never culled.
+        resource_handle import(const std::string& name);
+
+        pass_handle add_pass(const std::string& name, const setup_function& setup, execute_function execute);
+
+        void compile();
+
+        // Runs the passes that survived compile in order.
+        void execute() const;
+
+        // Removes every pass and resource.
+        void clear();
+
+        std::size_t pass_count() const noexcept;
+
+        std::size_t resource_count() const noexcept;
+
+        const std::string& pass_name(pass_handle pass) const;
+
+        const std::string& resource_name(resource_handle resource) const;
+
+        bool culled(pass_handle pass) const;
+
+        // Passes left after culling, in execution order.
+        const std::vector<pass_handle>& order() const noexcept;
+
+        // Passes that must finish before pass can start.
+        const std::vector<pass_handle>& dependencies(pass_handle pass) const;
+
+        std::size_t resource_size(resource_handle resource) const;
+
+        // Offset of a transient resource in the heap, NO_OFFSET for imported
+        // or unused resources.
+        std::size_t heap_offset(resource_handle resource) const;
+
+        // Memory needed for every transient resource with aliasing.
+        std::size_t heap_size() const noexcept;
+
+        // Memory the transient resources would need without aliasing.
+        std::size_t unaliased_size() const noexcept;
+
+    private:
+        struct pass {
+            std::string name;
+            execute_function execute;
+            std::vector<resource_handle> reads;
+            std::vector<resource_handle> writes;
+            std::vector<pass_handle> dependencies;
+            bool side_effect = false;
+            bool culled = false;
+            std::uint32_t references = 0;
+        };
+
+        struct resource {
+            std::string name;
+            std::size_t size = 0;
+            bool imported = false;
+            std::vector<pass_handle> writers;
+            std::vector<pass_handle> users;
+            std::uint32_t references = 0;
+            std::size_t first_use = 0;
+            std::size_t last_use = 0;
+            std::size_t offset = NO_OFFSET;
+        };
+
+        std::vector<pass> passes_;
+        std::vector<resource> resources_;
+        std::vector<pass_handle> order_;
+        std::size_t heap_size_ = 0;
+        std::size_t unaliased_size_ = 0;
+
+        resource_handle add_resource_(const std::string& name, std::size_t size, bool imported);
+
+        void cull_();
+
+        void link_();
+
+        void allocate_();
+
+        void link_aliases_(const std::vector<resource_handle>& placed);
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_FRAME_GRAPH_HPP
@@ -0,0 +1,113 @@
+#ifndef SIGMA_GRAPHICS_FRAME_PACKET_HPP
+#define SIGMA_GRAPHICS_FRAME_PACKET_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/graphics/directional_light.hpp>
+#include <sigma/graphics/point_light.hpp>
+#include <sigma/graphics/renderer.hpp>
+#include <sigma/graphics/spot_light.hpp>
+#include <sigma/graphics/static_mesh.hpp>
+#include <sigma/util/affine.hpp>
+
+#include <entt/entt.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // Tag for entities whose static_mesh_instance or lights were added,
+    // changed or removed since the last extraction. Transform changes are
+    // tracked by the transform_system instead.
+    struct render_changed {
+    };
+
+    // Copy of everything the renderer needs from the registry for one
+    // frame. Once extracted the packet does not reference the registry, so
+    // the render thread can read it while the next frame is simulated.
+    struct frame_packet {
+        using entity_type = entt::registry<>::entity_type;
+
+        struct mesh_instance {
+            entity_type entity;
+            affine::matrix model;
+            resource::handle_type<static_mesh> mesh;
+            bool cast_shadows;
+        };
+
+        struct point_light_instance {
+            entity_type entity;
+            glm::vec3 position;
+            point_light light;
+        };
+
+        struct spot_light_instance {
+            entity_type entity;
+            glm::vec3 position;
+            spot_light light;
+        };
+
+        struct directional_light_instance {
+            entity_type entity;
+            directional_light light;
+        };
+
+        std::uint64_t frame = 0;
+        view_port view;
+
+        // An incremental packet only holds the entities that changed since
+        // the previous packet, entities in removed are dropped from every
+        // list before the changed entries are applied.
+        bool incremental = false;
+        std::vector<entity_type> removed;
+
+        std::vector<mesh_instance> meshes;
+        std::vector<point_light_instance> point_lights;
+        std::vector<spot_light_instance> spot_lights;
+        std::vector<directional_light_instance> directional_lights;
+
+        // Empties the lists but keeps their memory for the next extraction.
+        void clear();
+    };
+
+    // Fills packet from the entities that have a transform and a
+    // static_mesh_instance or light component. World matrices are taken as
+    // the transform_system left them.
+    void extract(entt::registry<>& registry, const view_port& view, std::uint64_t frame, frame_packet& packet);
+
+    // Fills packet with the changes since the last extraction: entities
+    // the transform_system moved, entities tagged render_changed (the tags
+    // are removed) and destroyed entities. Costs O(changes), not O(scene).
+    void extract_changes(entt::registry<>& registry,
+        const view_port& view,
+        std::uint64_t frame,
+        const std::vector<frame_packet::entity_type>& moved,
+        const std::vector<frame_packet::entity_type>& destroyed,
+        frame_packet& packet);
+
+    // The renderer's copy of the scene, kept up to date by applying full or
+    // incremental packets in order.
+    class render_mirror {
+    public:
+        void apply(const frame_packet& packet);
+
+        const frame_packet& scene() const noexcept;
+
+    private:
+        using entity_type = frame_packet::entity_type;
+
+        frame_packet scene_;
+        std::unordered_map<entity_type, std::size_t> meshes_;
+        std::unordered_map<entity_type, std::size_t> point_lights_;
+        std::unordered_map<entity_type, std::size_t> spot_lights_;
+        std::unordered_map<entity_type, std::size_t> directional_lights_;
+
+        void rebuild_indices_();
+
+        void remove_(entity_type entity);
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_FRAME_PACKET_HPP
@@ -0,0 +1,86 @@
+#ifndef SIGMA_GRAPHICS_LIGHT_GRID_HPP
+#define SIGMA_GRAPHICS_LIGHT_GRID_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/frame_allocator.hpp>
+#include <sigma/frustum.hpp>
+#include <sigma/graphics/frame_packet.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // Clustered light assignment. The view frustum is split into froxels,
+    // screen tiles in x and y and exponentially growing depth slices in z,
+    // and every point and spot light is assigned to the clusters its range
+    // reaches. Shading then only loops over the lights of its cluster.
+    //
+    // Slices are built in parallel. Within a slice each light is tested
+    // against eight clusters at a time, spheres against the cluster boxes
+    // and cones against the cluster bounding spheres.
+    //
+    // The cluster table and index list are per-frame data, they are
+    // allocated from the frame_allocator passed to build() and stay valid
+    // until that frame's arena is reused.
+    class light_grid {
+    public:
+        // Lights of cluster i are indices[offset, offset + point_count) into
+        // the point lights followed by spot_count indices into the spot lights.
+        struct cluster {
+            std::uint32_t offset;
+            std::uint32_t point_count;
+            std::uint32_t spot_count;
+        };
+
+        light_grid(glm::uvec3 dimensions = { 16, 9, 24 });
+
+        glm::uvec3 dimensions() const noexcept;
+
+        void set_dimensions(glm::uvec3 dimensions);
+
+        // frames needs a sub-arena for every worker thread.
+        void build(frame_allocator& frames, const frustum& view, const std::vector<frame_packet::point_light_instance>& point_lights, const std::vector<frame_packet::spot_light_instance>& spot_lights);
+
+        void build(frame_allocator& frames, const frustum& view, const frame_packet& packet);
+
+        std::size_t cluster_index(glm::uvec3 cell) const noexcept;
+
+        // Index of the cluster holding a view space position, the position
+        // must be inside the frustum.
+        std::size_t cluster_at(const glm::vec3& view_position) const;
+
+        const frame_vector<cluster>& clusters() const noexcept;
+
+        const frame_vector<std::uint32_t>& indices() const noexcept;
+
+    private:
+        // A light reaching cluster index (within its slice).
+        struct hit {
+            std::uint32_t cluster;
+            std::uint32_t light;
+        };
+
+        glm::uvec3 dimensions_;
+        std::size_t lane_stride_;
+        glm::mat4 projection_;
+        float z_near_;
+        float z_far_;
+
+        // View space cluster bounds, each slice padded to whole lanes.
+        std::vector<float> min_x_, min_y_, min_z_, max_x_, max_y_, max_z_;
+        std::vector<frame_vector<hit>> slice_points_;
+        std::vector<frame_vector<hit>> slice_spots_;
+        frame_vector<cluster> clusters_;
+        frame_vector<std::uint32_t> indices_;
+
+        float slice_depth_(std::uint32_t slice) const noexcept;
+
+        void build_bounds_(const frustum& view);
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_LIGHT_GRID_HPP
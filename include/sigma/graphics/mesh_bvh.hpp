@@ -0,0 +1,148 @@
+#ifndef SIGMA_GRAPHICS_MESH_BVH_HPP
+#define SIGMA_GRAPHICS_MESH_BVH_HPP
+
+#include <sigma/bvh.hpp>
+#include <sigma/config.hpp>
+#include <sigma/graphics/static_mesh.hpp>
+#include <sigma/resource/resource.hpp>
+#include <sigma/util/glm_serialize.hpp>
+
+#include <cereal/types/vector.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // Triangle bvh of a static_mesh for ray queries (picking, line of sight).
+    // Built once from the mesh and cached next to it, the triangles are
+    // stored as a corner and two edges so they can be tested without going
+    // back to the mesh vertices.
+    class mesh_bvh : public resource::base_resource {
+    public:
+        static constexpr std::uint32_t NO_HIT = std::numeric_limits<std::uint32_t>::max();
+
+        struct hit {
+            std::uint32_t triangle = NO_HIT;
+            float distance = std::numeric_limits<float>::max();
+            // Weights of the second and third triangle corners.
+            glm::vec2 barycentric { 0.0f };
+        };
+
+        // Rays traversing the tree together. Lanes are culled from a node
+        // independently, coherent rays (a pixel block, a fan of line of
+        // sight checks) share most of the traversal.
+        template <std::size_t N>
+        struct ray_packet {
+            static_assert(N <= 64, "ray packets are limited to 64 rays");
+
+            std::array<glm::vec3, N> origin;
+            std::array<glm::vec3, N> direction;
+            std::array<float, N> max_distance;
+        };
+
+        mesh_bvh(std::weak_ptr<sigma::context> ctx, resource::key_type key);
+
+        void build(const static_mesh& mesh);
+
+        std::size_t size() const noexcept;
+
+        const bvh& tree() const noexcept;
+
+        bool closest_hit(const glm::vec3& origin, const glm::vec3& direction, float max_distance, hit& result) const;
+
+        bool any_hit(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const;
+
+        // Returns a mask of the lanes that hit something.
+        template <std::size_t N>
+        std::uint64_t closest_hit(const ray_packet<N>& rays, std::array<hit, N>& results) const
+        {
+            std::array<glm::vec3, N> inv_direction;
+            std::array<float, N> max_distance = rays.max_distance;
+            for (std::size_t i = 0; i < N; ++i) {
+                inv_direction[i] = 1.0f / rays.direction[i];
+                results[i] = hit {};
+            }
+
+            std::uint64_t hits = 0;
+            tree_.traverse(full_mask_<N>(),
+                [&](const bvh::node& n, std::uint64_t& mask) {
+                    return cull_lanes_<N>(rays.origin, inv_direction, max_distance, n.min, n.max, mask);
+                },
+                [&](std::uint32_t triangle, std::uint64_t mask) {
+                    for (std::size_t i = 0; i < N; ++i) {
+                        if ((mask & (std::uint64_t(1) << i)) && intersect_(triangle, rays.origin[i], rays.direction[i], max_distance[i], results[i]))
+                            hits |= std::uint64_t(1) << i;
+                    }
+                });
+            return hits;
+        }
+
+        // Returns a mask of the lanes that hit something, lanes stop
+        // traversing at their first hit.
+        template <std::size_t N>
+        std::uint64_t any_hit(const ray_packet<N>& rays) const
+        {
+            std::array<glm::vec3, N> inv_direction;
+            std::array<float, N> max_distance = rays.max_distance;
+            for (std::size_t i = 0; i < N; ++i)
+                inv_direction[i] = 1.0f / rays.direction[i];
+
+            std::uint64_t hits = 0;
+            tree_.traverse(full_mask_<N>(),
+                [&](const bvh::node& n, std::uint64_t& mask) {
+                    mask &= ~hits;
+                    return cull_lanes_<N>(rays.origin, inv_direction, max_distance, n.min, n.max, mask);
+                },
+                [&](std::uint32_t triangle, std::uint64_t mask) {
+                    hit ignored;
+                    for (std::size_t i = 0; i < N; ++i) {
+                        if ((mask & ~hits & (std::uint64_t(1) << i)) && intersect_(triangle, rays.origin[i], rays.direction[i], max_distance[i], ignored))
+                            hits |= std::uint64_t(1) << i;
+                    }
+                });
+            return hits;
+        }
+
+        template <class Archive>
+        void serialize(Archive& ar)
+        {
+            ar(tree_, corners_, edges1_, edges2_);
+        }
+
+    private:
+        bvh tree_;
+        std::vector<glm::vec3> corners_;
+        std::vector<glm::vec3> edges1_;
+        std::vector<glm::vec3> edges2_;
+
+        // Moller-Trumbore, updates result and shrinks max_distance when the
+        // triangle is hit closer than max_distance.
+        bool intersect_(std::uint32_t triangle, const glm::vec3& origin, const glm::vec3& direction, float& max_distance, hit& result) const noexcept;
+
+        template <std::size_t N>
+        static constexpr std::uint64_t full_mask_()
+        {
+            return N == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << N) - 1;
+        }
+
+        template <std::size_t N>
+        static bool cull_lanes_(const std::array<glm::vec3, N>& origin, const std::array<glm::vec3, N>& inv_direction, const std::array<float, N>& max_distance, const glm::vec3& min, const glm::vec3& max, std::uint64_t& mask) noexcept
+        {
+            for (std::size_t i = 0; i < N; ++i) {
+                if ((mask & (std::uint64_t(1) << i)) && !bvh::intersects(origin[i], inv_direction[i], max_distance[i], min, max))
+                    mask &= ~(std::uint64_t(1) << i);
+            }
+            return mask != 0;
+        }
+    };
+}
+}
+
+REGISTER_RESOURCE(sigma::graphics::mesh_bvh, mesh_bvh, 1);
+
+#endif // SIGMA_GRAPHICS_MESH_BVH_HPP
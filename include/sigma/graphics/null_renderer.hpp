@@ -0,0 +1,89 @@
+#ifndef SIGMA_GRAPHICS_NULL_RENDERER_HPP
+#define SIGMA_GRAPHICS_NULL_RENDERER_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/frame_allocator.hpp>
+#include <sigma/graphics/render_queue.hpp>
+#include <sigma/graphics/renderer.hpp>
+#include <sigma/graphics/state_stream.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // Renderer that runs the CPU side of a frame like a GPU backend would
+    // (merging, sorting, batching, state tracking and uniform packing) but
+    // records the resulting state changes to memory instead of calling a
+    // graphics API. Meant for benchmarks and tests on machines without a GPU.
+    //
+    // The per-draw uniforms are packed into the context's render_memory(),
+    // render() does not advance it. The uniforms of a render stay valid
+    // until that frame allocator reuses the frame.
+    class null_renderer : public renderer {
+    public:
+        // Uniform buffer offset alignment views are packed with.
+        static constexpr std::size_t UNIFORM_ALIGNMENT = 256;
+
+        struct stage_timings {
+            std::chrono::nanoseconds sort { 0 };
+            std::chrono::nanoseconds batch { 0 };
+            std::chrono::nanoseconds state { 0 };
+            std::chrono::nanoseconds pack { 0 };
+            std::chrono::nanoseconds submit { 0 };
+            std::chrono::nanoseconds total { 0 };
+        };
+
+        // std140 block written for every draw ahead of its instances.
+        struct draw_block {
+            std::uint32_t instance_offset;
+            std::uint32_t instance_count;
+            std::uint32_t padding[2];
+        };
+
+        null_renderer(glm::ivec2 size, std::shared_ptr<sigma::context> ctx);
+
+        render_queue* queue() override;
+
+        void resize(glm::uvec2 size) override;
+
+        // Processes and records the queued commands, then clears the queue.
+        void render() override;
+
+        glm::uvec2 size() const noexcept;
+
+        std::uint64_t frame_count() const noexcept;
+
+        const stage_timings& timings() const noexcept;
+
+        const state_stream::statistics& stats() const noexcept;
+
+        // State changes recorded by the last render.
+        const std::vector<state_change>& recorded() const noexcept;
+
+        // Uniform data packed by the last render: a draw_block for every
+        // draw followed by the instance matrices.
+        const frame_vector<std::byte>& uniforms() const noexcept;
+
+        // The std140 view blocks packed by the last render, bound by
+        // offset view * view_stride().
+        const std::vector<std::byte>& view_uniforms() const noexcept;
+
+        std::size_t view_stride() const noexcept;
+
+    private:
+        glm::uvec2 size_;
+        std::uint64_t frame_count_ = 0;
+        render_queue queue_;
+        state_stream stream_;
+        stage_timings timings_;
+        std::vector<state_change> recorded_;
+        frame_vector<std::byte> uniforms_;
+        std::vector<std::byte> view_uniforms_;
+        std::size_t view_stride_ = 0;
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_NULL_RENDERER_HPP
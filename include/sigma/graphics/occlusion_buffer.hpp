@@ -0,0 +1,79 @@
+#ifndef SIGMA_GRAPHICS_OCCLUSION_BUFFER_HPP
+#define SIGMA_GRAPHICS_OCCLUSION_BUFFER_HPP
+
+#include <sigma/AABB.hpp>
+#include <sigma/config.hpp>
+#include <sigma/graphics/static_mesh.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // Software occlusion culling. Occluder meshes (usually low resolution
+    // proxies) are rasterized on the CPU into a small depth buffer split
+    // into tiles that are filled in parallel, then a hierarchical-Z pyramid
+    // holding the farthest depth of each region is built so bounds can be
+    // tested against it with a handful of reads.
+    //
+    // Depth is stored as window depth in [0, 1] with 1 being the far plane.
+    class occlusion_buffer {
+    public:
+        static constexpr int TILE_SIZE = 32;
+
+        occlusion_buffer(glm::ivec2 size = { 256, 128 });
+
+        glm::ivec2 size() const noexcept;
+
+        void resize(glm::ivec2 size);
+
+        // Clears the buffer and starts a new frame seen through projection_view.
+        void begin(const glm::mat4& projection_view);
+
+        void add_occluder(const static_mesh& mesh, const glm::mat4& model);
+
+        void add_occluder(const std::vector<glm::vec3>& positions, const std::vector<static_mesh::triangle>& triangles, const glm::mat4& model);
+
+        // Rasterizes every added occluder and builds the hierarchical-Z pyramid.
+        void render();
+
+        bool is_visible(const glm::vec3& min, const glm::vec3& max) const;
+
+        bool is_visible(const AABB& bounds) const;
+
+        std::size_t level_count() const noexcept;
+
+        glm::ivec2 level_size(std::size_t level) const;
+
+        float depth(std::size_t level, glm::ivec2 pixel) const;
+
+    private:
+        struct screen_triangle {
+            glm::vec3 v0;
+            glm::vec3 v1;
+            glm::vec3 v2;
+        };
+
+        glm::ivec2 size_;
+        glm::ivec2 tile_count_;
+        glm::mat4 projection_view_;
+        std::vector<screen_triangle> triangles_;
+        std::vector<std::vector<std::uint32_t>> bins_;
+        std::vector<glm::ivec2> level_sizes_;
+        std::vector<std::vector<float>> levels_;
+
+        void add_triangle_(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2);
+
+        void rasterize_tile_(int tile);
+
+        void build_hierarchy_();
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_OCCLUSION_BUFFER_HPP
@@ -3,6 +3,7 @@
 
 #include <sigma/config.hpp>
 
+#include <cereal/cereal.hpp>
 #include <glm/vec3.hpp>
 
 namespace sigma {
@@ -10,10 +11,13 @@ namespace graphics {
     struct point_light {
         glm::vec3 color;
         float intensity;
+        // Distance past which the light is treated as having no effect.
+        float range;
 
-        point_light(const glm::vec3& color = { 1.0f, 1.0f, 1.0f }, float intensity = 1.0f)
+        point_light(const glm::vec3& color = { 1.0f, 1.0f, 1.0f }, float intensity = 1.0f, float range = 10.0f)
             : color { color }
             , intensity { intensity }
+            , range { range }
         {
         }
 
@@ -21,9 +25,13 @@ namespace graphics {
         void serialize(Archive& ar, const unsigned int version)
         {
             ar(color, intensity);
+            if (version >= 1)
+                ar(range);
         }
     };
 }
 }
 
+CEREAL_CLASS_VERSION(sigma::graphics::point_light, 1);
+
 #endif // SIGMA_GRAPHICS_POINT_LIGHT_HPP
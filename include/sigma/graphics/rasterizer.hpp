@@ -0,0 +1,92 @@
+#ifndef SIGMA_GRAPHICS_RASTERIZER_HPP
+#define SIGMA_GRAPHICS_RASTERIZER_HPP
+
+#include <sigma/config.hpp>
+
+#include <glm/common.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+namespace sigma {
+namespace graphics {
+    // Triangle setup shared by the CPU rasterizers (occlusion_buffer and
+    // software_renderer). Screen space has y up, pixel (x, y) is sampled at
+    // its center and front faces are counter clockwise.
+    namespace rasterizer {
+        // Pixels are processed in rows of this many lanes, written as fixed
+        // length loops without branches for the compiler to vectorize.
+        constexpr int LANE_COUNT = 8;
+
+        // Smallest clip space w treated as in front of the eye.
+        constexpr float MIN_W = 1e-5f;
+
+        // Coefficients of the edge function from a to b, positive on the
+        // left of the edge (inside for counter clockwise triangles).
+        //
+        // Pixels exactly on an edge follow the top-left rule: they belong to
+        // the triangle only if the edge is a left edge (going down) or a top
+        // edge (horizontal, going left), so a pixel on an edge shared by two
+        // triangles is drawn once.
+        struct edge {
+            float a;
+            float b;
+            float c;
+            bool top_left;
+
+            edge(const glm::vec3& from, const glm::vec3& to)
+                : a(from.y - to.y)
+                , b(to.x - from.x)
+                , c(to.y * from.x - to.x * from.y)
+                , top_left(a > 0 || (a == 0 && b < 0))
+            {
+            }
+
+            float operator()(float x, float y) const noexcept
+            {
+                return a * x + b * y + c;
+            }
+
+            // Whether a pixel where the edge function is value is covered.
+            bool covers(float value) const noexcept
+            {
+                return (value > 0) | ((value == 0) & top_left);
+            }
+        };
+
+        // Twice the signed screen area, zero or negative for degenerate and
+        // back facing triangles.
+        inline float signed_area(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+        {
+            return edge(v0, v1)(v2.x, v2.y);
+        }
+
+        inline bool is_front_facing(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+        {
+            return signed_area(v0, v1, v2) > 0;
+        }
+
+        inline void screen_bounds(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, glm::vec2& min, glm::vec2& max)
+        {
+            min = glm::min(glm::min(glm::vec2 { v0 }, glm::vec2 { v1 }), glm::vec2 { v2 });
+            max = glm::max(glm::max(glm::vec2 { v0 }, glm::vec2 { v1 }), glm::vec2 { v2 });
+        }
+
+        // The first and last tile the bounds of a triangle touch on a screen
+        // of size pixels split into tile_count tiles of tile_size pixels.
+        // False when the triangle is off screen.
+        inline bool tile_range(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, glm::ivec2 size, int tile_size, glm::ivec2 tile_count, glm::ivec2& first, glm::ivec2& last)
+        {
+            glm::vec2 min, max;
+            screen_bounds(v0, v1, v2, min, max);
+            if (max.x < 0 || max.y < 0 || min.x >= size.x || min.y >= size.y)
+                return false;
+
+            first = glm::clamp(glm::ivec2 { glm::floor(min) } / tile_size, glm::ivec2 { 0 }, tile_count - 1);
+            last = glm::clamp(glm::ivec2 { glm::floor(max) } / tile_size, glm::ivec2 { 0 }, tile_count - 1);
+            return true;
+        }
+    }
+}
+}
+
+#endif // SIGMA_GRAPHICS_RASTERIZER_HPP
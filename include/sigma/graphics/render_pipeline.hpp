@@ -0,0 +1,77 @@
+#ifndef SIGMA_GRAPHICS_RENDER_PIPELINE_HPP
+#define SIGMA_GRAPHICS_RENDER_PIPELINE_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/frame_allocator.hpp>
+#include <sigma/graphics/frame_packet.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace sigma {
+namespace graphics {
+    // Runs rendering on its own thread one frame behind the simulation.
+    // There are two frame packets: while the render thread consumes packet
+    // N the game thread extracts frame N + 1 into the other one, so a frame
+    // takes as long as the slower of the two stages instead of their sum.
+    //
+    // The consume function runs on the render thread, a renderer that owns
+    // a graphics API context has to make it current there. The frame
+    // allocator passed in, usually the context's render_memory(), is
+    // advanced on the render thread before every packet and must not be
+    // used by other threads.
+    class render_pipeline {
+    public:
+        using consume_function = std::function<void(const frame_packet&)>;
+
+        render_pipeline(consume_function consume, frame_allocator* frames = nullptr);
+
+        // Renders every submitted packet before stopping the thread.
+        ~render_pipeline();
+
+        // The packet to extract the next frame into. Blocks while the render
+        // thread still reads it, i.e. when the game is two frames ahead.
+        frame_packet& begin_frame();
+
+        // Hands the packet returned by begin_frame to the render thread.
+        void submit();
+
+        // Blocks until every submitted packet has been rendered.
+        void flush();
+
+        std::uint64_t submitted_frames() const;
+
+        std::uint64_t rendered_frames() const;
+
+    private:
+        render_pipeline(const render_pipeline&) = delete;
+
+        render_pipeline& operator=(const render_pipeline&) = delete;
+
+        enum class slot_state {
+            free,
+            ready,
+            rendering
+        };
+
+        consume_function consume_;
+        frame_allocator* frames_;
+        std::array<frame_packet, 2> packets_;
+        std::array<slot_state, 2> states_;
+        std::uint64_t submitted_ = 0;
+        std::uint64_t rendered_ = 0;
+        bool stopping_ = false;
+        mutable std::mutex mutex_;
+        std::condition_variable changed_;
+        std::thread thread_;
+
+        void run_();
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_RENDER_PIPELINE_HPP
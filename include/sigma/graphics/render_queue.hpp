@@ -1,9 +1,17 @@
 #pragma once
 
 #include <sigma/config.hpp>
+#include <sigma/graphics/standard_block.hpp>
+#include <sigma/util/affine.hpp>
+#include <sigma/util/glm_serialize.hpp>
+
+#include <cereal/cereal.hpp>
 
 #include <glm/mat4x4.hpp>
 
+#include <cstdint>
+#include <vector>
+
 static const constexpr uint64_t MAX_RENDER_TARGETS = 4;
 static const constexpr uint64_t MAX_TEXTURE_BINDINGS = 16;
 static const constexpr uint64_t MAX_BUFFER_BINDINGS = 16;
@@ -21,12 +29,66 @@ namespace graphics {
         uint64_t offset;
         uint64_t count;
 
-        glm::mat4 model;
-        glm::mat4 projection_view;
+        affine::matrix model;
+        // Index of the view in render_queue::views().
+        std::uint32_t view;
+
+        template <class Archive>
+        void serialize(Archive& ar)
+        {
+            ar(group, program, buffer_bindings, input_textures, mesh, offset, count, model, view);
+        }
+    };
+
+    // Sort key layout, most significant bits first:
+    //   pass (8) | program (12) | material (16) | mesh (16) | depth (12)
+    // so commands are grouped by pass, then by state, then front to back.
+    // Ids wider than their field are truncated, depth is the window depth
+    // in [0, 1].
+    std::uint64_t make_sort_key(std::uint8_t pass, std::uint32_t program, std::uint32_t material, std::uint32_t mesh, float depth);
+
+    // Sort key for blended passes where draws must go back to front:
+    //   pass (8) | inverted depth (24) | program (12) | material (16) | 0 (4)
+    std::uint64_t make_blended_sort_key(std::uint8_t pass, float depth, std::uint32_t program, std::uint32_t material);
+
+    // Commands recorded by one thread. Appending touches nothing shared,
+    // the bucket keeps its memory between frames.
+    class command_bucket {
+    public:
+        render_command* enqueue(std::uint64_t key = 0);
+
+        std::size_t size() const noexcept;
+
+        void clear();
+
+    private:
+        friend class render_queue;
+
+        std::vector<render_command> commands_;
+        std::vector<std::uint64_t> keys_;
     };
 
+    // Commands are stored in enqueue order and never move, sorting only
+    // reorders (key, index) entries that point into them.
+    //
+    // Several threads can record at once, each into its own bucket, and the
+    // buckets are merged into the queue before sorting.
     class render_queue {
     public:
+        struct entry {
+            std::uint64_t key;
+            std::uint32_t index;
+        };
+
+        // One instanced draw: the state of the command at entries()[first]
+        // drawn instance_count times with the model matrices starting at
+        // instances()[instance_offset].
+        struct batch {
+            std::uint32_t first;
+            std::uint32_t instance_offset;
+            std::uint32_t instance_count;
+        };
+
         render_queue(uint64_t id)
             : id_(id)
         {
@@ -36,10 +98,72 @@ namespace graphics {
 
         uint64_t id() const { return id_; }
 
-        virtual render_command* enqueue() { return nullptr; }
+        // Appends a command, it stays valid until the next enqueue or clear.
+        render_command* enqueue(std::uint64_t key = 0);
+
+        std::size_t size() const noexcept;
+
+        bool empty() const noexcept;
+
+        void clear();
+
+        // Adds the constants of a view seen this frame, commands reference
+        // it by the returned index. Views are cleared with the commands.
+        std::uint32_t add_view(const standard_block& block);
+
+        const std::vector<standard_block>& views() const noexcept;
+
+        // Makes sure there are at least count buckets.
+        void reserve_buckets(std::size_t count);
+
+        std::size_t bucket_count() const noexcept;
+
+        // A bucket must only be used by one thread at a time. Buckets are
+        // merged in index order, recording with one bucket per parallel_for
+        // chunk gives the same queue whatever the number of threads.
+        command_bucket& bucket(std::size_t index);
+
+        // Appends the commands of every bucket to the queue in bucket order,
+        // in parallel, and empties the buckets.
+        void merge();
+
+        // Sorts the entries by key with a parallel LSD radix sort, commands
+        // with equal keys keep their enqueue order.
+        void sort();
+
+        // Entries in sorted order after sort, enqueue order before.
+        const std::vector<entry>& entries() const noexcept;
+
+        const std::vector<render_command>& commands() const noexcept;
+
+        const render_command& command(const entry& e) const;
+
+        // Collapses runs of sorted entries whose commands only differ by
+        // their model matrix (same group, view, program, mesh, offset, count
+        // and bindings) into batches, packing the model matrices in draw order.
+        void build_batches();
+
+        const std::vector<batch>& batches() const noexcept;
+
+        // Per-frame instance data, rebuilt by build_batches.
+        const std::vector<affine::matrix>& instances() const noexcept;
+
+        // Whether a and b can be drawn as instances of one draw.
+        static bool can_instance(const render_command& a, const render_command& b) noexcept;
+
+        // Stable LSD radix sort of entries by key, scratch is used as the
+        // second buffer.
+        static void radix_sort(std::vector<entry>& entries, std::vector<entry>& scratch);
 
     private:
         uint64_t id_;
+        std::vector<render_command> commands_;
+        std::vector<entry> entries_;
+        std::vector<entry> scratch_;
+        std::vector<command_bucket> buckets_;
+        std::vector<standard_block> views_;
+        std::vector<batch> batches_;
+        std::vector<affine::matrix> instances_;
     };
 }
-}
\ No newline at end of file
+}
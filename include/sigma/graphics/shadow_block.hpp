@@ -10,12 +10,16 @@
 #include <glm/vec3.hpp>
 
 #include <array>
+#include <cstdint>
 
 namespace sigma {
 namespace graphics {
+    static const constexpr std::size_t MAX_SHADOW_CASCADES = 8;
+
     struct shadow_block {
-        std::array<glm::mat4, 3> light_projection_view_matrix;
-        std::array<glm::vec4, 3> light_frustum_far_plane;
+        std::array<glm::mat4, MAX_SHADOW_CASCADES> light_projection_view_matrix;
+        std::array<glm::vec4, MAX_SHADOW_CASCADES> light_frustum_far_plane;
+        std::uint32_t cascade_count;
     };
 }
 }
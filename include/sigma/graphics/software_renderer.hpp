@@ -0,0 +1,94 @@
+#ifndef SIGMA_GRAPHICS_SOFTWARE_RENDERER_HPP
+#define SIGMA_GRAPHICS_SOFTWARE_RENDERER_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/graphics/render_queue.hpp>
+#include <sigma/graphics/renderer.hpp>
+#include <sigma/graphics/static_mesh.hpp>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // The geometry pass outputs of the deferred pipeline. Planes are padded
+    // to whole tiles, pixel (x, y) is at y * stride + x.
+    struct gbuffer {
+        glm::ivec2 size;
+        int stride;
+        std::vector<glm::vec3> albedo;
+        std::vector<float> roughness;
+        std::vector<glm::vec3> normal;
+        // Window depth in [0, 1], 1 where nothing was drawn.
+        std::vector<float> depth;
+
+        std::size_t index(glm::ivec2 pixel) const noexcept;
+    };
+
+    // CPU reference renderer for static meshes. Commands are transformed in
+    // parallel, their triangles are binned into screen tiles and the tiles
+    // are rasterized in parallel with eight lane edge functions into the
+    // gbuffer. No GPU is needed so it runs in headless builds.
+    //
+    // A command draws count indices from offset (the whole mesh when count
+    // is 0) of the mesh registered with its mesh id, using the surface
+    // registered for its first input texture.
+    class software_renderer : public renderer {
+    public:
+        static constexpr int TILE_SIZE = 32;
+
+        struct surface {
+            glm::vec3 albedo { 1.0f };
+            float roughness = 1.0f;
+        };
+
+        software_renderer(glm::ivec2 size, std::shared_ptr<sigma::context> ctx);
+
+        render_queue* queue() override;
+
+        void resize(glm::uvec2 size) override;
+
+        // Rasterizes the queued commands into the gbuffer, then clears the queue.
+        void render() override;
+
+        void set_mesh(std::uint64_t id, resource::handle_type<static_mesh> mesh);
+
+        void set_surface(std::uint64_t texture, const surface& s);
+
+        const gbuffer& output() const noexcept;
+
+    private:
+        struct screen_triangle {
+            glm::vec3 v[3];
+            float inverse_w[3];
+            // World space normals divided by w for perspective correct
+            // interpolation.
+            glm::vec3 normal[3];
+            const surface* material;
+        };
+
+        glm::ivec2 tile_count_;
+        render_queue queue_;
+        gbuffer gbuffer_;
+        surface default_surface_;
+        std::unordered_map<std::uint64_t, resource::handle_type<static_mesh>> meshes_;
+        std::unordered_map<std::uint64_t, surface> surfaces_;
+        std::vector<std::vector<screen_triangle>> chunk_triangles_;
+        std::vector<std::vector<const screen_triangle*>> bins_;
+
+        void clear_();
+
+        void setup_(const render_command& cmd, std::vector<screen_triangle>& output) const;
+
+        void bin_(const screen_triangle& tri);
+
+        void rasterize_tile_(int tile);
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_SOFTWARE_RENDERER_HPP
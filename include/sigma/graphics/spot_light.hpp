@@ -5,6 +5,7 @@
 
 #include <sigma/frustum.hpp>
 
+#include <cereal/cereal.hpp>
 #include <glm/vec3.hpp>
 
 namespace sigma {
@@ -14,6 +15,8 @@ namespace graphics {
         float intensity;
         float cutoff;
         bool cast_shadows;
+        // Distance past which the light is treated as having no effect.
+        float range;
 
         glm::vec3 direction;
         frustum shadow_frustum;
@@ -23,11 +26,13 @@ namespace graphics {
             float cutoff = 0.3926991f,
             bool cast_shadows = true,
             const glm::vec3& direction = { 0.0f, 1.0f, 0.0f },
-            const frustum& shadow_frustum = { 2.0f * 0.3926991f, 1.0f, .01f, 100.0f })
+            const frustum& shadow_frustum = { 2.0f * 0.3926991f, 1.0f, .01f, 100.0f },
+            float range = 10.0f)
             : color { color }
             , intensity { intensity }
             , cutoff { cutoff }
             , cast_shadows { cast_shadows }
+            , range { range }
             , direction { direction }
             , shadow_frustum { shadow_frustum }
         {
@@ -37,9 +42,13 @@ namespace graphics {
         void serialize(Archive& ar, const unsigned int version)
         {
             ar(color, intensity, cutoff, cast_shadows);
+            if (version >= 1)
+                ar(range);
         }
     };
 }
 }
 
+CEREAL_CLASS_VERSION(sigma::graphics::spot_light, 1);
+
 #endif // SIGMA_GRAPHICS_SPOT_LIGHT_HPP
@@ -2,6 +2,8 @@
 #define SIGMA_GRAPHICS_STANDARD_BLOCK_HPP
 
 #include <sigma/config.hpp>
+#include <sigma/frustum.hpp>
+#include <sigma/util/glm_serialize.hpp>
 
 #include <glm/mat2x2.hpp>
 #include <glm/mat3x3.hpp>
@@ -9,9 +11,15 @@
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+#include <cstddef>
+#include <vector>
+
 namespace sigma {
 namespace graphics {
     struct standard_block {
+        // Size of the block in std140 layout.
+        static constexpr std::size_t STD140_SIZE = 432;
+
         glm::mat4 projection_matrix;
         glm::mat4 inverse_projection_matrix;
         glm::mat4 view_matrix;
@@ -24,7 +32,23 @@ namespace graphics {
         float fovy;
         float z_near;
         float z_far;
-    }
+
+        template <class Archive>
+        void serialize(Archive& ar)
+        {
+            ar(projection_matrix, inverse_projection_matrix, view_matrix, inverse_view_matrix, projection_view_matrix, inverse_projection_view_matrix, view_port_size, eye_position, time, fovy, z_near, z_far);
+        }
+    };
+
+    // Built once per view and frame, the inverses come from the frustum.
+    standard_block make_standard_block(const frustum& view, glm::ivec2 size, float time);
+
+    // Writes count blocks in std140 layout, block i at i * stride where
+    // stride is STD140_SIZE rounded up to alignment (the uniform buffer
+    // offset alignment) so every block can be bound by offset. Returns the
+    // stride.
+    std::size_t pack_std140(const standard_block* blocks, std::size_t count, std::size_t alignment, std::vector<std::byte>& output);
+}
 }
 
 #endif // SIGMA_GRAPHICS_STANDARD_BLOCK_HPP
@@ -0,0 +1,58 @@
+#ifndef SIGMA_GRAPHICS_STATE_STREAM_HPP
+#define SIGMA_GRAPHICS_STATE_STREAM_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/graphics/render_queue.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    enum class state_op : std::uint8_t {
+        bind_view,
+        bind_group,
+        bind_program,
+        bind_buffer,
+        bind_texture,
+        bind_mesh,
+        draw
+    };
+
+    // For binds value is the bound id and slot the binding point, views are
+    // bound by their index in render_queue::views(). For draws value is the
+    // index of the batch in render_queue::batches().
+    struct state_change {
+        state_op op;
+        std::uint8_t slot;
+        std::uint64_t value;
+    };
+
+    // Walks the batches of a sorted queue and records only the state that
+    // changes between draws, so a backend replays a few binds per draw
+    // instead of the full view, group, program, mesh and 32 binding slots.
+    class state_stream {
+    public:
+        struct statistics {
+            std::size_t binds = 0;
+            std::size_t eliminated_binds = 0;
+            std::size_t draws = 0;
+        };
+
+        // render_queue::build_batches must have been called on queue.
+        void build(const render_queue& queue);
+
+        void clear();
+
+        const std::vector<state_change>& changes() const noexcept;
+
+        const statistics& stats() const noexcept;
+
+    private:
+        std::vector<state_change> changes_;
+        statistics stats_;
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_STATE_STREAM_HPP
@@ -1,6 +1,7 @@
 #ifndef SIGMA_GRAPHICS_STATIC_MESH_HPP
 #define SIGMA_GRAPHICS_STATIC_MESH_HPP
 
+#include <sigma/AABB.hpp>
 #include <sigma/config.hpp>
 #include <sigma/graphics/material.hpp>
 #include <sigma/resource/resource.hpp>
@@ -16,6 +17,18 @@
 
 namespace sigma {
 namespace graphics {
+    struct bounding_sphere {
+        glm::vec3 center { 0.0f };
+        float radius = 0.0f;
+
+        template <class Archive>
+        void serialize(Archive& ar)
+        {
+            ar(center, radius);
+        }
+    };
+
+    // Range of triangles [start, end) drawn with one material.
     class mesh_part {
     public:
         mesh_part();
@@ -28,18 +41,31 @@ namespace graphics {
 
         resource::handle_type<graphics::material> material() const;
 
+        const AABB& bounds() const;
+
+        const bounding_sphere& sphere() const;
+
+        void set_bounds(const AABB& bounds, const bounding_sphere& sphere);
+
         template <class Archive>
-        void serialize(Archive& ar)
+        void serialize(Archive& ar, const unsigned int version)
         {
             ar(start_, end_, material_);
+            if (version >= 1)
+                ar(bounds_, sphere_);
         }
 
     private:
         std::size_t start_;
         std::size_t end_;
         resource::handle_type<graphics::material> material_;
+        AABB bounds_;
+        bounding_sphere sphere_;
     };
 
+    // The bounds of the mesh and of its parts are computed by
+    // compute_bounds() when the mesh is built and are serialized with it.
+    // Meshes from streams older than version 2 compute them on load.
     class static_mesh : public resource::base_resource {
     public:
         struct vertex {
@@ -76,14 +102,35 @@ namespace graphics {
 
         void set_radius(float r);
 
+        const AABB& bounds() const;
+
+        const bounding_sphere& sphere() const;
+
+        // Computes the bounds of the whole mesh and of every part from the
+        // vertices, call it again after changing the geometry. The radius is
+        // left to set_radius().
+        void compute_bounds();
+
         template <class Archive>
-        void serialize(Archive& ar)
+        void save(Archive& ar, const unsigned int version) const
+        {
+            ar(radius_, vertices_, triangles_, parts_, bounds_, sphere_);
+        }
+
+        template <class Archive>
+        void load(Archive& ar, const unsigned int version)
         {
             ar(radius_, vertices_, triangles_, parts_);
+            if (version >= 2)
+                ar(bounds_, sphere_);
+            else
+                compute_bounds();
         }
 
     private:
         float radius_ = 0;
+        AABB bounds_;
+        bounding_sphere sphere_;
         std::vector<vertex> vertices_;
         std::vector<triangle> triangles_;
         std::vector<mesh_part> parts_;
@@ -91,6 +138,8 @@ namespace graphics {
 }
 }
 
-REGISTER_RESOURCE(sigma::graphics::static_mesh, static_mesh, 1);
+CEREAL_CLASS_VERSION(sigma::graphics::mesh_part, 1);
+
+REGISTER_RESOURCE(sigma::graphics::static_mesh, static_mesh, 2);
 
 #endif // SIGMA_GRAPHICS_STATIC_MESH_HPP
@@ -0,0 +1,74 @@
+#ifndef SIGMA_GRAPHICS_VIEW_CULLER_HPP
+#define SIGMA_GRAPHICS_VIEW_CULLER_HPP
+
+#include <sigma/bvh.hpp>
+#include <sigma/config.hpp>
+#include <sigma/frame_allocator.hpp>
+#include <sigma/frustum.hpp>
+
+#include <glm/mat4x4.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace sigma {
+namespace graphics {
+    // Culls a scene against every active view (camera, shadow cascades, spot
+    // light shadows...) in a single traversal of the scene bvh. Each
+    // primitive gets a mask with bit N set if it is visible in view N.
+    class view_culler {
+    public:
+        static constexpr std::size_t MAX_VIEWS = 64;
+
+        view_culler() = default;
+
+        std::size_t view_count() const noexcept;
+
+        std::size_t add_view(const frustum& view);
+
+        std::size_t add_view(const glm::mat4& projection_view);
+
+        void clear() noexcept;
+
+        bool test(const glm::vec3& min, const glm::vec3& max, std::uint64_t& mask) const noexcept;
+
+        void cull(const bvh& scene, std::vector<std::uint64_t>& masks) const;
+
+        void build_draw_list(const std::vector<std::uint64_t>& masks, std::size_t view, std::vector<std::uint32_t>& draw_list) const;
+
+        void build_draw_lists(const std::vector<std::uint64_t>& masks, std::vector<std::vector<std::uint32_t>>& draw_lists) const;
+
+        // Same as above with the output in per-frame memory, masks and
+        // draw_list have to be created for the current frame. draw_lists are
+        // recreated from the allocator of masks.
+        void cull(const bvh& scene, frame_vector<std::uint64_t>& masks) const;
+
+        void build_draw_list(const frame_vector<std::uint64_t>& masks, std::size_t view, frame_vector<std::uint32_t>& draw_list) const;
+
+        void build_draw_lists(const frame_vector<std::uint64_t>& masks, std::vector<frame_vector<std::uint32_t>>& draw_lists) const;
+
+    private:
+        std::size_t view_count_ = 0;
+        // Planes are stored plane major, view minor so a plane can be tested
+        // against every view in one pass.
+        std::array<std::array<float, MAX_VIEWS>, 6> x_;
+        std::array<std::array<float, MAX_VIEWS>, 6> y_;
+        std::array<std::array<float, MAX_VIEWS>, 6> z_;
+        std::array<std::array<float, MAX_VIEWS>, 6> w_;
+
+        std::size_t add_planes_(const std::array<glm::vec4, 6>& planes);
+
+        template <class Masks>
+        void cull_(const bvh& scene, Masks& masks) const;
+
+        template <class Masks, class List>
+        void build_draw_list_(const Masks& masks, std::size_t view, List& draw_list) const;
+
+        template <class Masks, class List>
+        void build_draw_lists_(const Masks& masks, std::vector<List>& draw_lists) const;
+    };
+}
+}
+
+#endif // SIGMA_GRAPHICS_VIEW_CULLER_HPP
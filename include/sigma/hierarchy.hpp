@@ -0,0 +1,31 @@
+#ifndef SIGMA_HIERARCHY_HPP
+#define SIGMA_HIERARCHY_HPP
+
+#include <sigma/config.hpp>
+
+#include <entt/entt.hpp>
+
+#include <cstdint>
+#include <limits>
+
+namespace sigma {
+// Parent link of an entity whose transform is relative to another entity.
+// Entities without one are roots. depth is kept up to date by the
+// transform_system, roots are at depth zero.
+struct hierarchy {
+    using entity_type = entt::registry<>::entity_type;
+
+    static constexpr entity_type NO_PARENT = std::numeric_limits<entity_type>::max();
+
+    entity_type parent;
+    std::uint32_t depth;
+
+    hierarchy(entity_type parent = NO_PARENT, std::uint32_t depth = 1)
+        : parent { parent }
+        , depth { depth }
+    {
+    }
+};
+}
+
+#endif // SIGMA_HIERARCHY_HPP
@@ -0,0 +1,192 @@
+#ifndef SIGMA_SPATIAL_HASH_HPP
+#define SIGMA_SPATIAL_HASH_HPP
+
+#include <sigma/AABB.hpp>
+#include <sigma/config.hpp>
+#include <sigma/frustum.hpp>
+
+#include <glm/common.hpp>
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace sigma {
+// Loose hashed uniform grid for moving objects. Objects are stored in the
+// single cell containing the center of their bounds, queries are expanded by
+// the largest half size seen so objects overhanging their cell are still
+// found. Inserting, moving and removing an object are all O(1), except
+// when the last object of the largest size shrinks or leaves and the
+// expansion is recomputed from every object.
+class spatial_hash {
+public:
+    spatial_hash(float cell_size = 8.0f);
+
+    spatial_hash(spatial_hash&&) = default;
+
+    spatial_hash& operator=(spatial_hash&&) = default;
+
+    float cell_size() const noexcept;
+
+    std::size_t size() const noexcept;
+
+    // Cells currently holding objects. Cells are recycled as soon as they
+    // empty, so this stays bounded by the number of objects.
+    std::size_t cell_count() const noexcept;
+
+    // Largest half size of any contained object, queries are expanded by it.
+    glm::vec3 loose() const noexcept;
+
+    bool contains(std::uint32_t id) const noexcept;
+
+    void insert(std::uint32_t id, const AABB& bounds);
+
+    void insert(std::uint32_t id, const glm::vec3& min, const glm::vec3& max);
+
+    void update(std::uint32_t id, const AABB& bounds);
+
+    void update(std::uint32_t id, const glm::vec3& min, const glm::vec3& max);
+
+    void remove(std::uint32_t id);
+
+    void clear();
+
+    template <class F>
+    void query(const glm::vec3& min, const glm::vec3& max, F&& f) const
+    {
+        for_each_cell_(min, max, [&](const cell& c) {
+            for (auto id : c.ids) {
+                const auto& e = entries_[id];
+                if (e.min.x <= max.x && min.x <= e.max.x && e.min.y <= max.y && min.y <= e.max.y && e.min.z <= max.z && min.z <= e.max.z)
+                    f(id);
+            }
+        });
+    }
+
+    template <class F>
+    void query(const AABB& box, F&& f) const
+    {
+        query(box.min(), box.max(), std::forward<F>(f));
+    }
+
+    template <class F>
+    void query(const glm::vec3& center, float radius, F&& f) const
+    {
+        const float radius2 = radius * radius;
+        for_each_cell_(center - radius, center + radius, [&](const cell& c) {
+            for (auto id : c.ids) {
+                const auto& e = entries_[id];
+                glm::vec3 d = glm::clamp(center, e.min, e.max) - center;
+                if (glm::dot(d, d) <= radius2)
+                    f(id);
+            }
+        });
+    }
+
+    template <class F>
+    void query(const frustum& view, F&& f) const
+    {
+        glm::vec3 min { std::numeric_limits<float>::max() };
+        glm::vec3 max { std::numeric_limits<float>::lowest() };
+        for (const auto& c : view.corners()) {
+            min = glm::min(min, glm::vec3 { c });
+            max = glm::max(max, glm::vec3 { c });
+        }
+
+        for_each_cell_(min, max, [&](const cell& c) {
+            glm::vec3 cell_min = glm::vec3 { c.coordinate } * cell_size_ - loose_;
+            glm::vec3 cell_max = cell_min + cell_size_ + 2.0f * loose_;
+            if (!view.contains_box(cell_min, cell_max))
+                return;
+
+            for (auto id : c.ids) {
+                const auto& e = entries_[id];
+                if (view.contains_box(e.min, e.max))
+                    f(id);
+            }
+        });
+    }
+
+private:
+    spatial_hash(const spatial_hash&) = delete;
+
+    spatial_hash& operator=(const spatial_hash&) = delete;
+
+    static constexpr std::uint32_t INVALID_CELL = std::numeric_limits<std::uint32_t>::max();
+
+    struct entry {
+        glm::vec3 min;
+        std::uint32_t cell = INVALID_CELL;
+        glm::vec3 max;
+        std::uint32_t slot = 0;
+    };
+
+    struct cell {
+        glm::ivec3 coordinate;
+        std::vector<std::uint32_t> ids;
+    };
+
+    float cell_size_;
+    float inverse_cell_size_;
+    // Largest half size of any contained object and, per axis, how many
+    // objects have exactly that half size.
+    glm::vec3 loose_ { 0.0f };
+    std::array<std::size_t, 3> loose_count_ {};
+    std::size_t size_ = 0;
+    std::size_t occupied_cells_ = 0;
+    std::vector<entry> entries_;
+    std::vector<cell> cells_;
+    std::vector<std::uint32_t> free_cells_;
+    std::unordered_map<std::uint64_t, std::uint32_t> cell_lookup_;
+
+    glm::ivec3 coordinate_(const glm::vec3& p) const noexcept;
+
+    static std::uint64_t key_(const glm::ivec3& coordinate) noexcept;
+
+    std::uint32_t find_or_create_cell_(const glm::ivec3& coordinate);
+
+    void link_(std::uint32_t id, std::uint32_t cell_index);
+
+    void unlink_(std::uint32_t id);
+
+    void grow_loose_(const glm::vec3& half_size) noexcept;
+
+    void shrink_loose_(const glm::vec3& half_size);
+
+    template <class F>
+    void for_each_cell_(const glm::vec3& min, const glm::vec3& max, F&& f) const
+    {
+        glm::ivec3 lo = coordinate_(min - loose_);
+        glm::ivec3 hi = coordinate_(max + loose_);
+        glm::tvec3<std::int64_t> extent = glm::tvec3<std::int64_t> { hi - lo } + std::int64_t(1);
+
+        // Large query regions are cheaper to answer by walking the occupied
+        // cells than by probing every cell they cover.
+        if (extent.x * extent.y * extent.z > static_cast<std::int64_t>(occupied_cells_)) {
+            for (const auto& c : cells_) {
+                if (!c.ids.empty()
+                    && lo.x <= c.coordinate.x && c.coordinate.x <= hi.x
+                    && lo.y <= c.coordinate.y && c.coordinate.y <= hi.y
+                    && lo.z <= c.coordinate.z && c.coordinate.z <= hi.z)
+                    f(c);
+            }
+            return;
+        }
+
+        for (int z = lo.z; z <= hi.z; ++z) {
+            for (int y = lo.y; y <= hi.y; ++y) {
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    auto it = cell_lookup_.find(key_({ x, y, z }));
+                    if (it != cell_lookup_.end() && !cells_[it->second].ids.empty())
+                        f(cells_[it->second]);
+                }
+            }
+        }
+    }
+};
+}
+
+#endif // SIGMA_SPATIAL_HASH_HPP
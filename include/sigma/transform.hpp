@@ -2,6 +2,7 @@
 #define SIGMA_TRANSFORM_HPP
 
 #include <sigma/config.hpp>
+#include <sigma/util/affine.hpp>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -14,7 +15,12 @@ struct transform {
     glm::quat rotation;
     glm::vec3 scale;
 
-    glm::mat4 matrix;
+    // World matrix, computed by the transform_system.
+    affine::matrix matrix = affine::identity();
+
+    // Set when position, rotation or scale change so the transform_system
+    // recomputes matrix (and the matrices of its children).
+    bool dirty = true;
 
     transform(glm::vec3 position = glm::vec3 { 0 }, glm::quat rotation = glm::quat {}, glm::vec3 scale = glm::vec3 { 1 })
         : position(position)
@@ -27,6 +33,11 @@ struct transform {
     {
         return glm::translate(glm::mat4(1), position) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1), glm::vec3(scale));
     }
+
+    affine::matrix get_affine() const
+    {
+        return affine::compose(position, rotation, scale);
+    }
 };
 }
 
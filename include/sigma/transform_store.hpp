@@ -0,0 +1,95 @@
+#ifndef SIGMA_TRANSFORM_STORE_HPP
+#define SIGMA_TRANSFORM_STORE_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/transform.hpp>
+#include <sigma/util/affine.hpp>
+
+#include <entt/entt.hpp>
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sigma {
+// Positions, rotations and scales of many entities stored as one array per
+// component so model matrices can be composed several at a time. Entities
+// are kept densely packed, removing one moves the last entity into its
+// place.
+class transform_store {
+public:
+    using entity_type = entt::registry<>::entity_type;
+
+    // Read only view of a range of the component arrays.
+    struct arrays {
+        const float* position[3];
+        const float* rotation[4];
+        const float* scale[3];
+    };
+
+    transform_store() = default;
+
+    transform_store(transform_store&&) = default;
+
+    transform_store& operator=(transform_store&&) = default;
+
+    std::size_t size() const noexcept;
+
+    bool contains(entity_type entity) const noexcept;
+
+    void insert(entity_type entity, const transform& t);
+
+    void remove(entity_type entity);
+
+    void clear();
+
+    glm::vec3 position(entity_type entity) const;
+
+    void set_position(entity_type entity, const glm::vec3& position);
+
+    glm::quat rotation(entity_type entity) const;
+
+    void set_rotation(entity_type entity, const glm::quat& rotation);
+
+    glm::vec3 scale(entity_type entity) const;
+
+    void set_scale(entity_type entity, const glm::vec3& scale);
+
+    // Composes the model matrix of every entity, in parallel.
+    void compose();
+
+    const affine::matrix& matrix(entity_type entity) const;
+
+    // Entities and matrices in storage order.
+    const std::vector<entity_type>& entities() const noexcept;
+
+    const std::vector<affine::matrix>& matrices() const noexcept;
+
+    arrays data() const noexcept;
+
+    // translate * rotate * scale for count entities, several lanes at a
+    // time. Gives the same result as transform::get_affine.
+    static void compose(const arrays& input, std::size_t count, affine::matrix* output);
+
+private:
+    transform_store(const transform_store&) = delete;
+
+    transform_store& operator=(const transform_store&) = delete;
+
+    std::vector<float> position_[3];
+    std::vector<float> rotation_[4];
+    std::vector<float> scale_[3];
+    std::vector<affine::matrix> matrices_;
+    std::vector<entity_type> entities_;
+    std::unordered_map<entity_type, std::uint32_t> slots_;
+
+    std::uint32_t slot_(entity_type entity) const;
+};
+}
+
+#endif // SIGMA_TRANSFORM_STORE_HPP
@@ -0,0 +1,69 @@
+#ifndef SIGMA_TRANSFORM_SYSTEM_HPP
+#define SIGMA_TRANSFORM_SYSTEM_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/hierarchy.hpp>
+#include <sigma/transform.hpp>
+
+#include <entt/entt.hpp>
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sigma {
+// Computes the world matrix of every transform. Only dirty transforms and
+// the subtrees below them are recomputed.
+//
+// Every update collects the dirty transforms, set_parent and remove_parent
+// mark the child dirty. Dirty transforms below another dirty transform are
+// covered by its subtree and dropped, the remaining dirty roots have
+// independent subtrees which are walked in parallel. Hierarchy components
+// are kept sorted by depth in the registry.
+class transform_system {
+public:
+    using entity_type = entt::registry<>::entity_type;
+
+    transform_system() = default;
+
+    transform_system(transform_system&&) = default;
+
+    transform_system& operator=(transform_system&&) = default;
+
+    void set_parent(entt::registry<>& registry, entity_type child, entity_type parent);
+
+    void remove_parent(entt::registry<>& registry, entity_type child);
+
+    // Forces the depth order to be rebuilt, needed after hierarchy
+    // components are assigned, replaced or removed directly.
+    void invalidate() noexcept;
+
+    void update(entt::registry<>& registry);
+
+    // Entities whose world matrix changed during the last update.
+    const std::vector<entity_type>& changed() const noexcept;
+
+private:
+    transform_system(const transform_system&) = delete;
+
+    transform_system& operator=(const transform_system&) = delete;
+
+    bool order_dirty_ = true;
+    std::size_t hierarchy_count_ = 0;
+    // Children grouped by parent, child_ranges_ maps a parent to its range
+    // in children_.
+    std::vector<entity_type> children_;
+    std::unordered_map<entity_type, std::pair<std::size_t, std::size_t>> child_ranges_;
+    std::vector<entity_type> dirty_roots_;
+    std::vector<entity_type> changed_;
+
+    void rebuild_order_(entt::registry<>& registry);
+
+    bool has_dirty_ancestor_(entt::registry<>& registry, entity_type entity) const;
+
+    void update_subtree_(entt::registry<>& registry, entity_type root, std::vector<entity_type>& stack, std::vector<entity_type>& changed) const;
+};
+}
+
+#endif // SIGMA_TRANSFORM_SYSTEM_HPP
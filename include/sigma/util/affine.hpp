@@ -0,0 +1,106 @@
+#ifndef SIGMA_UTIL_AFFINE_HPP
+#define SIGMA_UTIL_AFFINE_HPP
+
+#include <sigma/config.hpp>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat3x4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+
+namespace sigma {
+namespace affine {
+    // Affine transform with an implied (0, 0, 0, 1) bottom row, stored as
+    // its three rows. That is 48 bytes instead of 64 and matches a std140
+    // mat3x4 applied in shaders as vec4(position, 1) * model.
+    using matrix = glm::mat3x4;
+
+    inline matrix identity()
+    {
+        return matrix { glm::vec4 { 1, 0, 0, 0 }, glm::vec4 { 0, 1, 0, 0 }, glm::vec4 { 0, 0, 1, 0 } };
+    }
+
+    // The rows of translate * rotate * scale.
+    inline matrix compose(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+    {
+        const float x = rotation.x;
+        const float y = rotation.y;
+        const float z = rotation.z;
+        const float w = rotation.w;
+        return matrix {
+            glm::vec4 { (1.0f - 2.0f * (y * y + z * z)) * scale.x, 2.0f * (x * y - w * z) * scale.y, 2.0f * (x * z + w * y) * scale.z, position.x },
+            glm::vec4 { 2.0f * (x * y + w * z) * scale.x, (1.0f - 2.0f * (x * x + z * z)) * scale.y, 2.0f * (y * z - w * x) * scale.z, position.y },
+            glm::vec4 { 2.0f * (x * z - w * y) * scale.x, 2.0f * (y * z + w * x) * scale.y, (1.0f - 2.0f * (x * x + y * y)) * scale.z, position.z }
+        };
+    }
+
+    inline matrix from_mat4(const glm::mat4& m)
+    {
+        return matrix {
+            glm::vec4 { m[0][0], m[1][0], m[2][0], m[3][0] },
+            glm::vec4 { m[0][1], m[1][1], m[2][1], m[3][1] },
+            glm::vec4 { m[0][2], m[1][2], m[2][2], m[3][2] }
+        };
+    }
+
+    inline glm::mat4 to_mat4(const matrix& a)
+    {
+        return glm::mat4 {
+            glm::vec4 { a[0][0], a[1][0], a[2][0], 0.0f },
+            glm::vec4 { a[0][1], a[1][1], a[2][1], 0.0f },
+            glm::vec4 { a[0][2], a[1][2], a[2][2], 0.0f },
+            glm::vec4 { a[0][3], a[1][3], a[2][3], 1.0f }
+        };
+    }
+
+    // a * b, every row of the result is one four wide multiply add chain.
+    inline matrix multiply(const matrix& a, const matrix& b)
+    {
+        matrix result;
+        for (int i = 0; i < 3; ++i)
+            result[i] = b[0] * a[i].x + b[1] * a[i].y + b[2] * a[i].z + glm::vec4 { 0.0f, 0.0f, 0.0f, a[i].w };
+        return result;
+    }
+
+    // Expands to a full matrix only where a projection is involved.
+    inline glm::mat4 multiply(const glm::mat4& projection_view, const matrix& model)
+    {
+        glm::mat4 result;
+        for (int j = 0; j < 4; ++j)
+            result[j] = projection_view[0] * model[0][j] + projection_view[1] * model[1][j] + projection_view[2] * model[2][j];
+        result[3] += projection_view[3];
+        return result;
+    }
+
+    inline glm::vec3 transform_point(const matrix& a, const glm::vec3& p)
+    {
+        const glm::vec4 h { p, 1.0f };
+        return { glm::dot(a[0], h), glm::dot(a[1], h), glm::dot(a[2], h) };
+    }
+
+    inline glm::vec3 transform_vector(const matrix& a, const glm::vec3& v)
+    {
+        const glm::vec4 h { v, 0.0f };
+        return { glm::dot(a[0], h), glm::dot(a[1], h), glm::dot(a[2], h) };
+    }
+
+    inline glm::vec3 translation(const matrix& a)
+    {
+        return { a[0].w, a[1].w, a[2].w };
+    }
+
+    // output[i] = a[i] * b[i] for count matrices.
+    void multiply(const matrix* a, const matrix* b, std::size_t count, matrix* output);
+
+    // output[i] = parent * b[i] for count matrices.
+    void multiply(const matrix& parent, const matrix* b, std::size_t count, matrix* output);
+
+    void transform_points(const matrix& a, const glm::vec3* points, std::size_t count, glm::vec3* output);
+}
+}
+
+#endif // SIGMA_UTIL_AFFINE_HPP
@@ -50,19 +50,19 @@ void serialize(Archive& ar, glm::tmat2x2<P>& v)
 template <class Archive, typename P>
 void serialize(Archive& ar, glm::tmat2x3<P>& v)
 {
-    ar(v[0], v[1], v[2]);
+    ar(v[0], v[1]);
 }
 
 template <class Archive, typename P>
 void serialize(Archive& ar, glm::tmat2x4<P>& v)
 {
-    ar(v[0], v[1], v[2], v[3]);
+    ar(v[0], v[1]);
 }
 
 template <class Archive, typename P>
 void serialize(Archive& ar, glm::tmat3x2<P>& v)
 {
-    ar(v[0], v[1]);
+    ar(v[0], v[1], v[2]);
 }
 
 template <class Archive, typename P>
@@ -74,19 +74,19 @@ void serialize(Archive& ar, glm::tmat3x3<P>& v)
 template <class Archive, typename P>
 void serialize(Archive& ar, glm::tmat3x4<P>& v)
 {
-    ar(v[0], v[1], v[2], v[3]);
+    ar(v[0], v[1], v[2]);
 }
 
 template <class Archive, typename P>
 void serialize(Archive& ar, glm::tmat4x2<P>& v)
 {
-    ar(v[0], v[1]);
+    ar(v[0], v[1], v[2], v[3]);
 }
 
 template <class Archive, typename P>
 void serialize(Archive& ar, glm::tmat4x3<P>& v)
 {
-    ar(v[0], v[1], v[2]);
+    ar(v[0], v[1], v[2], v[3]);
 }
 
 template <class Archive, typename P>
@@ -0,0 +1,55 @@
+#ifndef SIGMA_UTIL_PARALLEL_HPP
+#define SIGMA_UTIL_PARALLEL_HPP
+
+#include <sigma/config.hpp>
+#include <sigma/util/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace sigma {
+namespace util {
+    // Splits [0, count) into chunks of at most grain elements and calls
+    // f(begin, end) for each chunk on the shared thread_pool, the calling
+    // thread takes part. Chunks always start at a multiple of
+    // grain, small ranges run inline.
+    //
+    // f may also take a third argument, the index of the worker running the
+    // chunk in [0, worker_count()), e.g. to pick a per-thread sub-arena of a
+    // frame_allocator. The calling thread is worker 0.
+    template <class F>
+    void parallel_for(std::size_t count, std::size_t grain, F&& f)
+    {
+        auto call = [&f](std::size_t begin, std::size_t end, std::size_t worker) {
+            if constexpr (std::is_invocable_v<F&, std::size_t, std::size_t, std::size_t>)
+                f(begin, end, worker);
+            else
+                f(begin, end);
+        };
+
+        grain = std::max<std::size_t>(1, grain);
+        const std::size_t chunk_count = (count + grain - 1) / grain;
+        auto& pool = thread_pool::instance();
+        const std::size_t thread_count = std::min(pool.size(), chunk_count);
+        if (thread_count <= 1) {
+            for (std::size_t begin = 0; begin < count; begin += grain)
+                call(begin, std::min(count, begin + grain), 0);
+            return;
+        }
+
+        std::atomic<std::size_t> next_chunk { 0 };
+        auto work = [&](std::size_t worker) {
+            for (std::size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++) {
+                std::size_t begin = chunk * grain;
+                call(begin, std::min(count, begin + grain), worker);
+            }
+        };
+
+        pool.run(thread_count, work);
+    }
+}
+}
+
+#endif // SIGMA_UTIL_PARALLEL_HPP
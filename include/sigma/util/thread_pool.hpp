@@ -0,0 +1,73 @@
+#ifndef SIGMA_UTIL_THREAD_POOL_HPP
+#define SIGMA_UTIL_THREAD_POOL_HPP
+
+#include <sigma/config.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sigma {
+namespace util {
+    inline std::size_t worker_count()
+    {
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // Worker threads started once and kept waiting for jobs, so fanning out
+    // small per-frame workloads does not pay for creating threads.
+    //
+    // run() hands a job to the workers and to the calling thread and
+    // returns once every one of them has finished it, rethrowing the first
+    // exception a worker threw. One job runs at a
+    // time, other threads calling run() wait for it. A job calling run()
+    // again (nested parallelism) runs the inner job once on its own thread,
+    // with its own worker index, so indices stay unique per thread.
+    class thread_pool {
+    public:
+        // The calling thread counts as one of thread_count workers.
+        thread_pool(std::size_t thread_count = worker_count());
+
+        ~thread_pool();
+
+        std::size_t size() const noexcept;
+
+        // Calls job(worker) once for every worker in [0, min(count, size())),
+        // the calling thread is worker 0. Jobs are expected to share out
+        // their work dynamically, a worker may not take part.
+        void run(std::size_t count, const std::function<void(std::size_t)>& job);
+
+        // The pool shared by parallel_for, created on first use.
+        static thread_pool& instance();
+
+    private:
+        thread_pool(const thread_pool&) = delete;
+
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        std::vector<std::thread> threads_;
+        std::mutex run_mutex_;
+        std::mutex mutex_;
+        std::condition_variable start_;
+        std::condition_variable done_;
+        const std::function<void(std::size_t)>* job_ = nullptr;
+        std::exception_ptr error_;
+        std::size_t participants_ = 0;
+        std::size_t pending_ = 0;
+        std::uint64_t generation_ = 0;
+        bool stopping_ = false;
+
+        void work_(std::size_t worker);
+
+        void call_(std::size_t worker);
+    };
+}
+}
+
+#endif // SIGMA_UTIL_THREAD_POOL_HPP
@@ -0,0 +1,282 @@
+#include <sigma/broad_phase.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace sigma {
+namespace {
+    constexpr std::size_t LANE_COUNT = 8;
+
+    // A new axis has to be this much better before the order is rebuilt.
+    constexpr float AXIS_HYSTERESIS = 1.5f;
+}
+
+broad_phase::broad_phase(axis sweep_axis)
+    : requested_axis_(sweep_axis)
+    , sweep_axis_(sweep_axis == axis::automatic ? 0 : static_cast<std::size_t>(sweep_axis))
+{
+}
+
+std::size_t broad_phase::size() const noexcept
+{
+    return size_;
+}
+
+bool broad_phase::contains(id_type id) const noexcept
+{
+    return slots_.count(id) != 0;
+}
+
+void broad_phase::insert(id_type id, const AABB& bounds)
+{
+    insert(id, bounds.min(), bounds.max());
+}
+
+void broad_phase::insert(id_type id, const glm::vec3& min, const glm::vec3& max)
+{
+    if (contains(id)) {
+        update(id, min, max);
+        return;
+    }
+
+    std::uint32_t slot;
+    if (!free_.empty()) {
+        slot = free_.back();
+        free_.pop_back();
+    } else {
+        slot = static_cast<std::uint32_t>(ids_.size());
+        for (std::size_t a = 0; a < 3; ++a) {
+            min_[a].push_back(0.0f);
+            max_[a].push_back(0.0f);
+        }
+        ids_.push_back(id);
+        alive_.push_back(false);
+        stamps_.push_back(0);
+    }
+
+    for (std::size_t a = 0; a < 3; ++a) {
+        min_[a][slot] = min[a];
+        max_[a][slot] = max[a];
+    }
+    ids_[slot] = id;
+    alive_[slot] = true;
+    stamps_[slot] = stamp_;
+    slots_[id] = slot;
+    order_.push_back(slot);
+    size_++;
+}
+
+void broad_phase::update(id_type id, const AABB& bounds)
+{
+    update(id, bounds.min(), bounds.max());
+}
+
+void broad_phase::update(id_type id, const glm::vec3& min, const glm::vec3& max)
+{
+    const std::uint32_t slot = slots_.at(id);
+    for (std::size_t a = 0; a < 3; ++a) {
+        min_[a][slot] = min[a];
+        max_[a][slot] = max[a];
+    }
+    stamps_[slot] = stamp_;
+}
+
+void broad_phase::remove(id_type id)
+{
+    auto it = slots_.find(id);
+    if (it == slots_.end())
+        return;
+
+    // The slot stays in the order until the next sort drops it, it can not
+    // be reused before that.
+    alive_[it->second] = false;
+    slots_.erase(it);
+    size_--;
+}
+
+void broad_phase::clear()
+{
+    for (auto& v : min_)
+        v.clear();
+    for (auto& v : max_)
+        v.clear();
+    ids_.clear();
+    alive_.clear();
+    stamps_.clear();
+    free_.clear();
+    slots_.clear();
+    order_.clear();
+    size_ = 0;
+}
+
+void broad_phase::sweep()
+{
+    choose_axis_();
+    sort_();
+
+    const std::size_t a = sweep_axis_;
+    const std::size_t b = (a + 1) % 3;
+    const std::size_t c = (a + 2) % 3;
+    const float* a_min = sorted_min_[a].data();
+    const float* a_max = sorted_max_[a].data();
+    const float* b_min = sorted_min_[b].data();
+    const float* b_max = sorted_max_[b].data();
+    const float* c_min = sorted_min_[c].data();
+    const float* c_max = sorted_max_[c].data();
+
+    pair_keys_.clear();
+    const std::size_t count = order_.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t end = i + 1;
+        while (end < count && a_min[end] <= a_max[i])
+            end++;
+
+        // The other two axes are tested a full lane group at a time, the
+        // sorted arrays are padded with empty bounds so this never reads
+        // past them.
+        for (std::size_t j = i + 1; j < end; j += LANE_COUNT) {
+            bool hit[LANE_COUNT];
+            for (std::size_t lane = 0; lane < LANE_COUNT; ++lane) {
+                const std::size_t k = j + lane;
+                hit[lane] = (k < end) & (b_min[k] <= b_max[i]) & (b_min[i] <= b_max[k]) & (c_min[k] <= c_max[i]) & (c_min[i] <= c_max[k]);
+            }
+            for (std::size_t lane = 0; lane < LANE_COUNT; ++lane) {
+                if (hit[lane])
+                    pair_keys_.push_back(key_(ids_[order_[i]], ids_[order_[j + lane]]));
+            }
+        }
+    }
+    std::sort(pair_keys_.begin(), pair_keys_.end());
+
+    std::vector<std::uint64_t> changed;
+    begin_events_.clear();
+    std::set_difference(pair_keys_.begin(), pair_keys_.end(), previous_keys_.begin(), previous_keys_.end(), std::back_inserter(changed));
+    std::transform(changed.begin(), changed.end(), std::back_inserter(begin_events_), unpack_);
+
+    changed.clear();
+    end_events_.clear();
+    std::set_difference(previous_keys_.begin(), previous_keys_.end(), pair_keys_.begin(), pair_keys_.end(), std::back_inserter(changed));
+    std::transform(changed.begin(), changed.end(), std::back_inserter(end_events_), unpack_);
+
+    pairs_.clear();
+    std::transform(pair_keys_.begin(), pair_keys_.end(), std::back_inserter(pairs_), unpack_);
+    previous_keys_.swap(pair_keys_);
+}
+
+void broad_phase::update(entt::registry<>& registry)
+{
+    stamp_++;
+    registry.view<AABB>().each([this](auto entity, const AABB& bounds) {
+        insert(entity, bounds);
+    });
+
+    for (std::size_t slot = 0; slot < ids_.size(); ++slot) {
+        if (alive_[slot] && stamps_[slot] != stamp_)
+            remove(ids_[slot]);
+    }
+
+    sweep();
+}
+
+const std::vector<broad_phase::pair>& broad_phase::pairs() const noexcept
+{
+    return pairs_;
+}
+
+const std::vector<broad_phase::pair>& broad_phase::begin_events() const noexcept
+{
+    return begin_events_;
+}
+
+const std::vector<broad_phase::pair>& broad_phase::end_events() const noexcept
+{
+    return end_events_;
+}
+
+void broad_phase::choose_axis_()
+{
+    if (requested_axis_ != axis::automatic) {
+        sweep_axis_ = static_cast<std::size_t>(requested_axis_);
+        return;
+    }
+
+    if (size_ < 2)
+        return;
+
+    std::array<double, 3> sum {};
+    std::array<double, 3> sum2 {};
+    for (std::size_t slot = 0; slot < ids_.size(); ++slot) {
+        if (!alive_[slot])
+            continue;
+        for (std::size_t a = 0; a < 3; ++a) {
+            const double center = 0.5 * (double(min_[a][slot]) + double(max_[a][slot]));
+            sum[a] += center;
+            sum2[a] += center * center;
+        }
+    }
+
+    std::array<double, 3> variance;
+    for (std::size_t a = 0; a < 3; ++a) {
+        const double mean = sum[a] / double(size_);
+        variance[a] = sum2[a] / double(size_) - mean * mean;
+    }
+
+    std::size_t best = sweep_axis_;
+    for (std::size_t a = 0; a < 3; ++a) {
+        if (variance[a] > variance[best] * AXIS_HYSTERESIS)
+            best = a;
+    }
+
+    if (best != sweep_axis_) {
+        sweep_axis_ = best;
+        const auto& keys = min_[sweep_axis_];
+        std::sort(order_.begin(), order_.end(), [&](std::uint32_t l, std::uint32_t r) {
+            return keys[l] < keys[r];
+        });
+    }
+}
+
+void broad_phase::sort_()
+{
+    auto dead = std::stable_partition(order_.begin(), order_.end(), [this](std::uint32_t slot) { return bool(alive_[slot]); });
+    free_.insert(free_.end(), dead, order_.end());
+    order_.erase(dead, order_.end());
+
+    // Insertion sort, the order of the previous sweep is nearly right.
+    const auto& keys = min_[sweep_axis_];
+    for (std::size_t i = 1; i < order_.size(); ++i) {
+        const std::uint32_t slot = order_[i];
+        const float key = keys[slot];
+        std::size_t j = i;
+        for (; j > 0 && keys[order_[j - 1]] > key; --j)
+            order_[j] = order_[j - 1];
+        order_[j] = slot;
+    }
+
+    const std::size_t count = order_.size();
+    for (std::size_t a = 0; a < 3; ++a) {
+        sorted_min_[a].resize(count + LANE_COUNT);
+        sorted_max_[a].resize(count + LANE_COUNT);
+        for (std::size_t i = 0; i < count; ++i) {
+            sorted_min_[a][i] = min_[a][order_[i]];
+            sorted_max_[a][i] = max_[a][order_[i]];
+        }
+        std::fill(sorted_min_[a].begin() + count, sorted_min_[a].end(), std::numeric_limits<float>::max());
+        std::fill(sorted_max_[a].begin() + count, sorted_max_[a].end(), std::numeric_limits<float>::lowest());
+    }
+}
+
+std::uint64_t broad_phase::key_(id_type a, id_type b) noexcept
+{
+    if (b < a)
+        std::swap(a, b);
+    return (std::uint64_t(a) << 32) | std::uint64_t(b);
+}
+
+broad_phase::pair broad_phase::unpack_(std::uint64_t key) noexcept
+{
+    return { static_cast<id_type>(key >> 32), static_cast<id_type>(key & 0xFFFFFFFF) };
+}
+}
@@ -0,0 +1,337 @@
+#include <sigma/bvh.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <atomic>
+#include <future>
+#include <numeric>
+
+namespace sigma {
+namespace {
+    constexpr std::uint32_t INVALID_NODE = std::numeric_limits<std::uint32_t>::max();
+    constexpr std::uint32_t BIN_COUNT = 16;
+    constexpr std::uint32_t MIN_LEAF_SIZE = 4;
+    constexpr std::uint32_t MAX_LEAF_SIZE = 16;
+    constexpr std::uint32_t PARALLEL_THRESHOLD = 4096;
+    constexpr std::uint32_t PARALLEL_DEPTH = 6;
+    // Past this depth the builder only does median splits which at least
+    // halve the node so the tree never gets deeper than bvh::MAX_DEPTH.
+    constexpr std::uint32_t MEDIAN_DEPTH = bvh::MAX_DEPTH - 32;
+
+    float surface_area(const glm::vec3& min, const glm::vec3& max)
+    {
+        glm::vec3 e = glm::max(max - min, glm::vec3 { 0.0f });
+        return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+
+    struct bin {
+        glm::vec3 min { std::numeric_limits<float>::max() };
+        glm::vec3 max { std::numeric_limits<float>::lowest() };
+        std::uint32_t count = 0;
+    };
+
+    struct builder {
+        std::vector<bvh::node>& nodes;
+        std::vector<std::uint32_t>& parents;
+        std::vector<std::uint32_t>& indices;
+        std::vector<std::uint32_t>& leaves;
+        const std::vector<glm::vec3>& min;
+        const std::vector<glm::vec3>& max;
+        std::vector<glm::vec3> centroids;
+        std::atomic<std::uint32_t> node_count { 1 };
+
+        void make_leaf(std::uint32_t index, std::uint32_t begin, std::uint32_t end)
+        {
+            nodes[index].first = begin;
+            nodes[index].count = end - begin;
+            for (std::uint32_t i = begin; i < end; ++i)
+                leaves[indices[i]] = index;
+        }
+
+        std::uint32_t median_split(std::uint32_t begin, std::uint32_t end, int axis)
+        {
+            std::uint32_t mid = begin + (end - begin) / 2;
+            std::nth_element(indices.begin() + begin, indices.begin() + mid, indices.begin() + end, [&](std::uint32_t a, std::uint32_t b) {
+                return centroids[a][axis] < centroids[b][axis];
+            });
+            return mid;
+        }
+
+        void build(std::uint32_t index, std::uint32_t begin, std::uint32_t end, std::uint32_t depth)
+        {
+            auto& n = nodes[index];
+            n.min = glm::vec3 { std::numeric_limits<float>::max() };
+            n.max = glm::vec3 { std::numeric_limits<float>::lowest() };
+            glm::vec3 centroid_min { std::numeric_limits<float>::max() };
+            glm::vec3 centroid_max { std::numeric_limits<float>::lowest() };
+            for (std::uint32_t i = begin; i < end; ++i) {
+                auto p = indices[i];
+                n.min = glm::min(n.min, min[p]);
+                n.max = glm::max(n.max, max[p]);
+                centroid_min = glm::min(centroid_min, centroids[p]);
+                centroid_max = glm::max(centroid_max, centroids[p]);
+            }
+
+            std::uint32_t count = end - begin;
+            if (count <= MIN_LEAF_SIZE || depth >= bvh::MAX_DEPTH) {
+                make_leaf(index, begin, end);
+                return;
+            }
+
+            glm::vec3 extent = centroid_max - centroid_min;
+            int largest_axis = 0;
+            if (extent.y > extent[largest_axis])
+                largest_axis = 1;
+            if (extent.z > extent[largest_axis])
+                largest_axis = 2;
+
+            std::uint32_t mid = begin;
+            if (extent[largest_axis] <= 0.0f) {
+                // Every centroid is the same point, any split is as good as another.
+                mid = begin + count / 2;
+            } else if (depth >= MEDIAN_DEPTH) {
+                mid = median_split(begin, end, largest_axis);
+            } else {
+                float best_cost = std::numeric_limits<float>::max();
+                int best_axis = -1;
+                std::uint32_t best_split = 0;
+                for (int axis = 0; axis < 3; ++axis) {
+                    if (extent[axis] <= 0.0f)
+                        continue;
+
+                    std::array<bin, BIN_COUNT> bins;
+                    float scale = BIN_COUNT / extent[axis];
+                    for (std::uint32_t i = begin; i < end; ++i) {
+                        auto p = indices[i];
+                        auto b = std::min(BIN_COUNT - 1, static_cast<std::uint32_t>((centroids[p][axis] - centroid_min[axis]) * scale));
+                        bins[b].min = glm::min(bins[b].min, min[p]);
+                        bins[b].max = glm::max(bins[b].max, max[p]);
+                        bins[b].count++;
+                    }
+
+                    std::array<float, BIN_COUNT - 1> left_cost;
+                    bin left;
+                    for (std::uint32_t i = 0; i < BIN_COUNT - 1; ++i) {
+                        left.min = glm::min(left.min, bins[i].min);
+                        left.max = glm::max(left.max, bins[i].max);
+                        left.count += bins[i].count;
+                        left_cost[i] = left.count ? surface_area(left.min, left.max) * left.count : 0.0f;
+                    }
+
+                    bin right;
+                    for (std::uint32_t i = BIN_COUNT - 1; i > 0; --i) {
+                        right.min = glm::min(right.min, bins[i].min);
+                        right.max = glm::max(right.max, bins[i].max);
+                        right.count += bins[i].count;
+                        float cost = left_cost[i - 1] + (right.count ? surface_area(right.min, right.max) * right.count : 0.0f);
+                        if (right.count != count && right.count != 0 && cost < best_cost) {
+                            best_cost = cost;
+                            best_axis = axis;
+                            best_split = i;
+                        }
+                    }
+                }
+
+                float leaf_cost = surface_area(n.min, n.max) * count;
+                if (best_axis < 0) {
+                    mid = median_split(begin, end, largest_axis);
+                } else if (count <= MAX_LEAF_SIZE && leaf_cost <= best_cost) {
+                    make_leaf(index, begin, end);
+                    return;
+                } else {
+                    float scale = BIN_COUNT / extent[best_axis];
+                    auto it = std::partition(indices.begin() + begin, indices.begin() + end, [&](std::uint32_t p) {
+                        auto b = std::min(BIN_COUNT - 1, static_cast<std::uint32_t>((centroids[p][best_axis] - centroid_min[best_axis]) * scale));
+                        return b < best_split;
+                    });
+                    mid = static_cast<std::uint32_t>(it - indices.begin());
+                    if (mid == begin || mid == end)
+                        mid = median_split(begin, end, largest_axis);
+                }
+            }
+
+            std::uint32_t left = node_count.fetch_add(2);
+            n.first = left;
+            n.count = 0;
+            parents[left] = index;
+            parents[left + 1] = index;
+
+            if (count > PARALLEL_THRESHOLD && depth < PARALLEL_DEPTH) {
+                auto task = std::async(std::launch::async, [this, left, begin, mid, depth]() {
+                    build(left, begin, mid, depth + 1);
+                });
+                build(left + 1, mid, end, depth + 1);
+                task.get();
+            } else {
+                build(left, begin, mid, depth + 1);
+                build(left + 1, mid, end, depth + 1);
+            }
+        }
+    };
+}
+
+void bvh::build(const std::vector<AABB>& bounds)
+{
+    std::vector<glm::vec3> min(bounds.size());
+    std::vector<glm::vec3> max(bounds.size());
+    for (std::size_t i = 0; i < bounds.size(); ++i) {
+        min[i] = bounds[i].min();
+        max[i] = bounds[i].max();
+    }
+    build(min, max);
+}
+
+void bvh::build(const std::vector<glm::vec3>& min, const std::vector<glm::vec3>& max)
+{
+    min_ = min;
+    max_ = max;
+    dirty_.clear();
+
+    std::uint32_t count = static_cast<std::uint32_t>(min_.size());
+    indices_.resize(count);
+    std::iota(indices_.begin(), indices_.end(), 0);
+    leaves_.resize(count);
+
+    if (count == 0) {
+        nodes_.clear();
+        parents_.clear();
+        area_sum_ = 0;
+        build_cost_ = 0;
+        return;
+    }
+
+    nodes_.resize(2 * count - 1);
+    parents_.resize(2 * count - 1);
+
+    builder b { nodes_, parents_, indices_, leaves_, min_, max_, {} };
+    b.centroids.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i)
+        b.centroids[i] = (min_[i] + max_[i]) * 0.5f;
+
+    parents_[0] = INVALID_NODE;
+    b.build(0, 0, count, 0);
+
+    nodes_.resize(b.node_count);
+    parents_.resize(b.node_count);
+
+    area_sum_ = 0;
+    for (const auto& n : nodes_)
+        area_sum_ += node_weight_(n);
+    build_cost_ = cost();
+}
+
+void bvh::update(std::uint32_t primitive, const AABB& bounds)
+{
+    update(primitive, bounds.min(), bounds.max());
+}
+
+void bvh::update(std::uint32_t primitive, const glm::vec3& min, const glm::vec3& max)
+{
+    min_[primitive] = min;
+    max_[primitive] = max;
+    dirty_.push_back(leaves_[primitive]);
+}
+
+void bvh::refit()
+{
+    std::sort(dirty_.begin(), dirty_.end());
+    dirty_.erase(std::unique(dirty_.begin(), dirty_.end()), dirty_.end());
+
+    for (auto index : dirty_) {
+        while (index != INVALID_NODE) {
+            auto& n = nodes_[index];
+            glm::vec3 min, max;
+            if (n.is_leaf()) {
+                min = min_[indices_[n.first]];
+                max = max_[indices_[n.first]];
+                for (std::uint32_t i = n.first + 1; i < n.first + n.count; ++i) {
+                    min = glm::min(min, min_[indices_[i]]);
+                    max = glm::max(max, max_[indices_[i]]);
+                }
+            } else {
+                min = glm::min(nodes_[n.first].min, nodes_[n.first + 1].min);
+                max = glm::max(nodes_[n.first].max, nodes_[n.first + 1].max);
+            }
+
+            // If this node did not change none of its parents will.
+            if (min == n.min && max == n.max)
+                break;
+
+            area_sum_ -= node_weight_(n);
+            n.min = min;
+            n.max = max;
+            area_sum_ += node_weight_(n);
+
+            index = parents_[index];
+        }
+    }
+    dirty_.clear();
+}
+
+std::size_t bvh::size() const noexcept
+{
+    return min_.size();
+}
+
+bool bvh::empty() const noexcept
+{
+    return nodes_.empty();
+}
+
+const std::vector<bvh::node>& bvh::nodes() const noexcept
+{
+    return nodes_;
+}
+
+const std::vector<std::uint32_t>& bvh::indices() const noexcept
+{
+    return indices_;
+}
+
+const glm::vec3& bvh::min(std::uint32_t primitive) const noexcept
+{
+    return min_[primitive];
+}
+
+const glm::vec3& bvh::max(std::uint32_t primitive) const noexcept
+{
+    return max_[primitive];
+}
+
+float bvh::cost() const noexcept
+{
+    if (nodes_.empty())
+        return 0;
+
+    float root_area = surface_area(nodes_[0].min, nodes_[0].max);
+    if (root_area <= 0)
+        return 0;
+    return static_cast<float>(area_sum_ / root_area);
+}
+
+float bvh::build_cost() const noexcept
+{
+    return build_cost_;
+}
+
+float bvh::rebuild_ratio() const noexcept
+{
+    return rebuild_ratio_;
+}
+
+void bvh::set_rebuild_ratio(float ratio) noexcept
+{
+    rebuild_ratio_ = ratio;
+}
+
+bool bvh::needs_rebuild() const noexcept
+{
+    return cost() > build_cost_ * rebuild_ratio_;
+}
+
+float bvh::node_weight_(const node& n) const noexcept
+{
+    // SAH with a traversal and intersection cost of one.
+    return surface_area(n.min, n.max) * (n.is_leaf() ? n.count : 1);
+}
+}
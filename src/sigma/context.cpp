@@ -1,9 +1,13 @@
 #include <sigma/context.hpp>
 
+#include <sigma/util/parallel.hpp>
+
 namespace sigma {
 
 context::context(const std::filesystem::path& cache_path)
     : cache_path_ { cache_path }
+    , frame_memory_ { 1 << 20, util::worker_count() }
+    , render_memory_ { 1 << 20, 1 }
 {
 }
 
@@ -11,4 +15,14 @@ const std::filesystem::path& context::cache_path() const
 {
     return cache_path_;
 }
+
+frame_allocator& context::frame_memory()
+{
+    return frame_memory_;
+}
+
+frame_allocator& context::render_memory()
+{
+    return render_memory_;
+}
 }
@@ -0,0 +1,78 @@
+#include <sigma/frame_allocator.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sigma {
+frame_allocator::frame_allocator(std::size_t block_size, std::size_t thread_count)
+    : block_size_(std::max<std::size_t>(block_size, 64))
+    , thread_count_(std::max<std::size_t>(thread_count, 1))
+{
+    for (auto& arena : arenas_)
+        arena.resize(thread_count_);
+}
+
+std::size_t frame_allocator::thread_count() const noexcept
+{
+    return thread_count_;
+}
+
+std::uint64_t frame_allocator::frame() const noexcept
+{
+    return frame_;
+}
+
+void frame_allocator::begin_frame()
+{
+    frame_++;
+    for (auto& arena : arenas_[frame_ % FRAME_COUNT])
+        reset_(arena);
+}
+
+void* frame_allocator::allocate(std::size_t size, std::size_t alignment, std::size_t thread)
+{
+    if (thread >= thread_count_)
+        throw std::out_of_range("frame_allocator thread index out of range");
+
+    auto& arena = arenas_[frame_ % FRAME_COUNT][thread];
+    if (!arena.blocks.empty()) {
+        auto& current = arena.blocks.back();
+        auto address = reinterpret_cast<std::uintptr_t>(current.data.get()) + arena.offset;
+        std::size_t padding = (alignment - address % alignment) % alignment;
+        if (arena.offset + padding + size <= current.size) {
+            arena.offset += padding + size;
+            arena.used += size;
+            return current.data.get() + arena.offset - size;
+        }
+    }
+
+    // Blocks come from new[] and are aligned for max_align_t, larger
+    // alignments get room to shift the start.
+    std::size_t needed = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+    std::size_t size_of_block = std::max(block_size_, needed);
+    arena.blocks.push_back({ std::make_unique<std::byte[]>(size_of_block), size_of_block });
+    arena.offset = 0;
+    return allocate(size, alignment, thread);
+}
+
+std::size_t frame_allocator::used() const noexcept
+{
+    std::size_t total = 0;
+    for (const auto& arena : arenas_[frame_ % FRAME_COUNT])
+        total += arena.used;
+    return total;
+}
+
+void frame_allocator::reset_(sub_arena& arena)
+{
+    if (arena.blocks.size() > 1) {
+        std::size_t total = 0;
+        for (const auto& b : arena.blocks)
+            total += b.size;
+        arena.blocks.clear();
+        arena.blocks.push_back({ std::make_unique<std::byte[]>(total), total });
+    }
+    arena.offset = 0;
+    arena.used = 0;
+}
+}
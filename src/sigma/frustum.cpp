@@ -1,12 +1,73 @@
 #include <sigma/frustum.hpp>
 
 #include <glm/gtc/matrix_access.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 namespace sigma {
+std::size_t perspective_batch::size() const noexcept
+{
+    return view.size();
+}
+
+void perspective_batch::clear() noexcept
+{
+    fovy.clear();
+    aspect.clear();
+    z_near.clear();
+    z_far.clear();
+    view.clear();
+}
+
+void perspective_batch::push_back(float fovy, float aspect, float z_near, float z_far, const glm::mat4& view)
+{
+    this->fovy.push_back(fovy);
+    this->aspect.push_back(aspect);
+    this->z_near.push_back(z_near);
+    this->z_far.push_back(z_far);
+    this->view.push_back(view);
+}
+
+namespace {
+    // Same matrix as glm::perspective built from precomputed scales.
+    glm::mat4 perspective_matrix(float x_scale, float y_scale, float z_scale, float z_offset)
+    {
+        glm::mat4 result(0.0f);
+        result[0][0] = x_scale;
+        result[1][1] = y_scale;
+        result[2][2] = z_scale;
+        result[2][3] = -1.0f;
+        result[3][2] = z_offset;
+        return result;
+    }
+
+    template <class Output>
+    void build_perspective(const perspective_batch& batch, Output&& output)
+    {
+        const std::size_t count = batch.size();
+        std::vector<glm::vec4> scales(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const float y_scale = 1.0f / std::tan(batch.fovy[i] * 0.5f);
+            const float depth = batch.z_near[i] - batch.z_far[i];
+            scales[i] = {
+                y_scale / batch.aspect[i],
+                y_scale,
+                (batch.z_far[i] + batch.z_near[i]) / depth,
+                (2.0f * batch.z_far[i] * batch.z_near[i]) / depth
+            };
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            output(i, batch.fovy[i], batch.aspect[i], batch.z_near[i], batch.z_far[i], batch.view[i],
+                perspective_matrix(scales[i].x, scales[i].y, scales[i].z, scales[i].w));
+        }
+    }
+}
+
 frustum::frustum()
 {
     set_projection_view(0.785398f, 1.0f, 0.1f, 100.0f, glm::mat4 {});
@@ -17,6 +78,17 @@ frustum::frustum(float fovy, float aspect, float z_near, float z_far, const glm:
     set_projection_view(fovy, aspect, z_near, z_far, view);
 }
 
+frustum::frustum(float left, float right, float bottom, float top, float z_near, float z_far, const glm::mat4& view)
+{
+    view_ = view;
+    set_orthographic(left, right, bottom, top, z_near, z_far);
+}
+
+projection_type frustum::type() const
+{
+    return type_;
+}
+
 float frustum::fovy() const
 {
     return fovy_;
@@ -70,11 +142,18 @@ glm::mat4 frustum::projection() const
 
 void frustum::set_projection(float fovy, float aspect, float z_near, float z_far)
 {
-    fovy_ = fovy;
-    aspect_ = aspect;
+    set_perspective_(fovy, aspect, z_near, z_far);
+    rebuild_();
+}
+
+void frustum::set_orthographic(float left, float right, float bottom, float top, float z_near, float z_far)
+{
+    type_ = projection_type::orthographic;
+    fovy_ = 0.0f;
+    aspect_ = (right - left) / (top - bottom);
     z_near_ = z_near;
     z_far_ = z_far;
-    projection_ = glm::perspective(fovy_, aspect_, z_near_, z_far_);
+    projection_ = glm::ortho(left, right, bottom, top, z_near, z_far);
     rebuild_();
 }
 
@@ -85,12 +164,8 @@ glm::mat4 frustum::projection_view() const
 
 void frustum::set_projection_view(float fovy, float aspect, float z_near, float z_far, const glm::mat4& view)
 {
-    fovy_ = fovy;
-    aspect_ = aspect;
-    z_near_ = z_near;
-    z_far_ = z_far;
     view_ = view;
-    projection_ = glm::perspective(fovy_, aspect_, z_near_, z_far_);
+    set_perspective_(fovy, aspect, z_near, z_far);
     rebuild_();
 }
 
@@ -129,6 +204,11 @@ const std::array<glm::vec4, 8>& frustum::corners() const
     return corners_;
 }
 
+const std::array<glm::vec4, 6>& frustum::planes() const
+{
+    return planes_;
+}
+
 bool frustum::contains_sphere(const glm::vec3& center, float radius) const
 {
     for (const auto& plane : planes_) {
@@ -146,6 +226,27 @@ bool frustum::contains_sphere(const glm::vec3& center, float radius) const
     return true;
 }
 
+bool frustum::contains_box(const glm::vec3& min, const glm::vec3& max) const
+{
+    for (const auto& plane : planes_) {
+        // Test the corner furthest along the plane normal, if it is
+        // behind the plane the whole box is.
+        glm::vec3 p = {
+            plane.x >= 0 ? max.x : min.x,
+            plane.y >= 0 ? max.y : min.y,
+            plane.z >= 0 ? max.z : min.z
+        };
+        if (glm::dot(glm::vec3(plane), p) + plane.w < 0)
+            return false;
+    }
+    return true;
+}
+
+bool frustum::contains_box(const AABB& box) const
+{
+    return contains_box(box.min(), box.max());
+}
+
 glm::mat4 frustum::light_projection_(const glm::mat4& light_projection_view_matrix, float& minZ, float& maxZ, bool updateZ) const
 {
     float minX = std::numeric_limits<float>::max();
@@ -157,7 +258,7 @@ glm::mat4 frustum::light_projection_(const glm::mat4& light_projection_view_matr
         maxZ = std::numeric_limits<float>::min();
     }
 
-    for (auto c : corners_) {
+    for (auto c : corners()) {
         auto v = light_projection_view_matrix * c;
         v /= v.w;
         minX = std::min(minX, v.x);
@@ -173,13 +274,104 @@ glm::mat4 frustum::light_projection_(const glm::mat4& light_projection_view_matr
     return glm::ortho(minX, maxX, minY, maxY, -maxZ, -minZ);
 }
 
+void frustum::build(const perspective_batch& batch, frustum* output)
+{
+    build_perspective(batch, [output](std::size_t i, float fovy, float aspect, float z_near, float z_far, const glm::mat4& view, const glm::mat4& projection) {
+        output[i].assign_perspective_(fovy, aspect, z_near, z_far, view, projection);
+    });
+}
+
+void frustum::build(const perspective_batch& batch, frustum* const* output)
+{
+    build_perspective(batch, [output](std::size_t i, float fovy, float aspect, float z_near, float z_far, const glm::mat4& view, const glm::mat4& projection) {
+        output[i]->assign_perspective_(fovy, aspect, z_near, z_far, view, projection);
+    });
+}
+
+void frustum::assign_perspective_(float fovy, float aspect, float z_near, float z_far, const glm::mat4& view, const glm::mat4& projection)
+{
+    type_ = projection_type::perspective;
+    fovy_ = fovy;
+    aspect_ = aspect;
+    z_near_ = z_near;
+    z_far_ = z_far;
+    view_ = view;
+    projection_ = projection;
+    rebuild_();
+}
+
+void frustum::set_perspective_(float fovy, float aspect, float z_near, float z_far)
+{
+    type_ = projection_type::perspective;
+    fovy_ = fovy;
+    aspect_ = aspect;
+    z_near_ = z_near;
+    z_far_ = z_far;
+    projection_ = glm::perspective(fovy_, aspect_, z_near_, z_far_);
+}
+
 void frustum::rebuild_()
 {
-    projection_view_ = projection_ * view_;
-    inverse_view_ = glm::inverse(view_);
-    inverse_projection_ = glm::inverse(projection_);
-    inverse_projection_view_ = glm::inverse(projection_view_);
+    if (type_ == projection_type::perspective) {
+        // Only five entries of a perspective matrix are non zero, skip the
+        // full matrix product.
+        const float x_scale = projection_[0][0];
+        const float y_scale = projection_[1][1];
+        const float z_scale = projection_[2][2];
+        const float z_offset = projection_[3][2];
+        for (int i = 0; i < 4; ++i) {
+            const auto& v = view_[i];
+            projection_view_[i] = { x_scale * v.x, y_scale * v.y, z_scale * v.z + z_offset * v.w, -v.z };
+        }
+    } else {
+        projection_view_ = projection_ * view_;
+    }
+
+    // http://gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
+    planes_[0] = glm::row(projection_view_, 3) + glm::row(projection_view_, 0);
+    planes_[1] = glm::row(projection_view_, 3) - glm::row(projection_view_, 0);
 
+    planes_[2] = glm::row(projection_view_, 3) + glm::row(projection_view_, 1);
+    planes_[3] = glm::row(projection_view_, 3) - glm::row(projection_view_, 1);
+
+    planes_[4] = glm::row(projection_view_, 3) + glm::row(projection_view_, 2);
+    planes_[5] = glm::row(projection_view_, 3) - glm::row(projection_view_, 2);
+
+    for (auto& plane : planes_)
+    {
+        plane = plane / glm::length(glm::vec3(plane));
+    }
+
+    update_inverses_();
+    update_corners_();
+}
+
+void frustum::update_inverses_()
+{
+    inverse_view_ = glm::affineInverse(view_);
+
+    inverse_projection_ = glm::mat4(0.0f);
+    if (type_ == projection_type::perspective) {
+        const float z_scale = projection_[2][2];
+        const float z_offset = projection_[3][2];
+        inverse_projection_[0][0] = 1.0f / projection_[0][0];
+        inverse_projection_[1][1] = 1.0f / projection_[1][1];
+        inverse_projection_[2][3] = 1.0f / z_offset;
+        inverse_projection_[3][2] = -1.0f;
+        inverse_projection_[3][3] = z_scale / z_offset;
+    } else {
+        for (int i = 0; i < 3; ++i) {
+            inverse_projection_[i][i] = 1.0f / projection_[i][i];
+            inverse_projection_[3][i] = -projection_[3][i] / projection_[i][i];
+        }
+        inverse_projection_[3][3] = 1.0f;
+    }
+
+    inverse_projection_view_ = inverse_view_ * inverse_projection_;
+}
+
+void frustum::update_corners_()
+{
     corners_[0] = { -1, -1, -1, 1 };
     corners_[1] = { -1, 1, -1, 1 };
     corners_[2] = { 1, 1, -1, 1 };
@@ -205,20 +397,5 @@ void frustum::rebuild_()
     }
 
     diagonal_ = glm::length(glm::vec3(corners_[6] - corners_[0]));
-
-    // http://gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
-    planes_[0] = glm::row(projection_view_, 3) + glm::row(projection_view_, 0);
-    planes_[1] = glm::row(projection_view_, 3) - glm::row(projection_view_, 0);
-
-    planes_[2] = glm::row(projection_view_, 3) + glm::row(projection_view_, 1);
-    planes_[3] = glm::row(projection_view_, 3) - glm::row(projection_view_, 1);
-
-    planes_[4] = glm::row(projection_view_, 3) + glm::row(projection_view_, 2);
-    planes_[5] = glm::row(projection_view_, 3) - glm::row(projection_view_, 2);
-
-    for (auto& plane : planes_)
-    {
-        plane = plane / glm::length(glm::vec3(plane));
-    }
 }
 }
@@ -0,0 +1,204 @@
+#include <sigma/graphics/cascade_builder.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace sigma {
+namespace graphics {
+    namespace {
+        // Sphere radii are rounded up to this step so floating point noise
+        // in the slice corners does not change the cascade size.
+        constexpr float RADIUS_STEP = 1.0f / 16.0f;
+    }
+
+    cascade_builder::cascade_builder(std::size_t cascade_count, std::uint32_t resolution)
+        : split_lambda_(0.75f)
+        , invalidated_(true)
+    {
+        intervals_.fill(1);
+        updated_.fill(false);
+        splits_.fill(0.0f);
+        block_.light_projection_view_matrix.fill(glm::mat4(1));
+        block_.light_frustum_far_plane.fill(glm::vec4(0));
+        set_cascade_count(cascade_count);
+        set_resolution(resolution);
+    }
+
+    std::size_t cascade_builder::cascade_count() const noexcept
+    {
+        return cascade_count_;
+    }
+
+    void cascade_builder::set_cascade_count(std::size_t count)
+    {
+        if (count == 0 || count > MAX_SHADOW_CASCADES)
+            throw std::out_of_range("cascade count must be between 1 and MAX_SHADOW_CASCADES");
+        cascade_count_ = count;
+        block_.cascade_count = static_cast<std::uint32_t>(count);
+        invalidated_ = true;
+    }
+
+    std::uint32_t cascade_builder::resolution() const noexcept
+    {
+        return resolution_;
+    }
+
+    void cascade_builder::set_resolution(std::uint32_t resolution)
+    {
+        if (resolution == 0)
+            throw std::invalid_argument("shadow map resolution can not be zero");
+        resolution_ = resolution;
+        invalidated_ = true;
+    }
+
+    float cascade_builder::split_lambda() const noexcept
+    {
+        return split_lambda_;
+    }
+
+    void cascade_builder::set_split_lambda(float lambda)
+    {
+        split_lambda_ = glm::clamp(lambda, 0.0f, 1.0f);
+        invalidated_ = true;
+    }
+
+    std::uint32_t cascade_builder::update_interval(std::size_t cascade) const
+    {
+        return intervals_.at(cascade);
+    }
+
+    void cascade_builder::set_update_interval(std::size_t cascade, std::uint32_t frames)
+    {
+        intervals_.at(cascade) = std::max<std::uint32_t>(1, frames);
+    }
+
+    void cascade_builder::invalidate() noexcept
+    {
+        invalidated_ = true;
+    }
+
+    void cascade_builder::update(const frustum& camera, const glm::vec3& light_direction, const std::vector<AABB>& casters, std::uint64_t frame)
+    {
+        const glm::vec3 direction = glm::normalize(light_direction);
+        const glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3 { 0, 0, 1 } : glm::vec3 { 0, 1, 0 };
+
+        // The light view only rotates, cascades are placed by their
+        // projection so that snapping happens in a fixed frame.
+        const glm::mat4 light_view = glm::lookAt(glm::vec3 { 0 }, direction, up);
+
+        std::vector<glm::vec3> caster_min(casters.size());
+        std::vector<glm::vec3> caster_max(casters.size());
+        const glm::mat3 rotation { light_view };
+        const glm::mat3 abs_rotation { glm::abs(rotation[0]), glm::abs(rotation[1]), glm::abs(rotation[2]) };
+        for (std::size_t i = 0; i < casters.size(); ++i) {
+            const glm::vec3 center = rotation * ((casters[i].min() + casters[i].max()) * 0.5f);
+            const glm::vec3 extent = abs_rotation * ((casters[i].max() - casters[i].min()) * 0.5f);
+            caster_min[i] = center - extent;
+            caster_max[i] = center + extent;
+        }
+
+        glm::vec4 far_plane = camera.far_plane();
+        far_plane /= glm::length(glm::vec3 { far_plane });
+
+        const float z_near = camera.z_near();
+        const float z_far = camera.z_far();
+        const auto& camera_corners = camera.corners();
+        float previous_split = z_near;
+        for (std::size_t i = 0; i < cascade_count_; ++i) {
+            const float t = float(i + 1) / float(cascade_count_);
+            const float log_split = z_near * std::pow(z_far / z_near, t);
+            const float linear_split = z_near + (z_far - z_near) * t;
+            const float split = split_lambda_ * log_split + (1.0f - split_lambda_) * linear_split;
+
+            const bool due = invalidated_ || (frame + i) % intervals_[i] == 0;
+            updated_[i] = due;
+            if (due) {
+                const float t0 = (previous_split - z_near) / (z_far - z_near);
+                const float t1 = (split - z_near) / (z_far - z_near);
+                std::array<glm::vec3, 8> corners;
+                for (std::size_t j = 0; j < 4; ++j) {
+                    const glm::vec3 near_corner { camera_corners[j] };
+                    const glm::vec3 far_corner { camera_corners[j + 4] };
+                    corners[j] = near_corner + (far_corner - near_corner) * t0;
+                    corners[j + 4] = near_corner + (far_corner - near_corner) * t1;
+                }
+                splits_[i] = split;
+                fit_(i, corners, far_plane, light_view, caster_min, caster_max);
+            }
+            previous_split = split;
+        }
+        invalidated_ = false;
+    }
+
+    bool cascade_builder::needs_render(std::size_t cascade) const
+    {
+        return cascade < cascade_count_ && updated_[cascade];
+    }
+
+    float cascade_builder::split(std::size_t cascade) const
+    {
+        return splits_.at(cascade);
+    }
+
+    const glm::mat4& cascade_builder::projection_view(std::size_t cascade) const
+    {
+        return block_.light_projection_view_matrix.at(cascade);
+    }
+
+    const shadow_block& cascade_builder::block() const noexcept
+    {
+        return block_;
+    }
+
+    void cascade_builder::fit_(std::size_t cascade, const std::array<glm::vec3, 8>& corners, const glm::vec4& far_plane, const glm::mat4& light_view, const std::vector<glm::vec3>& caster_min, const std::vector<glm::vec3>& caster_max)
+    {
+        // The slice has the same shape whatever the camera orientation is,
+        // so its bounding sphere only moves with the camera.
+        glm::vec3 center { 0 };
+        for (const auto& c : corners)
+            center += c;
+        center /= 8.0f;
+
+        float radius = 0.0f;
+        for (const auto& c : corners)
+            radius = std::max(radius, glm::distance(c, center));
+        radius = std::ceil(radius / RADIUS_STEP) * RADIUS_STEP;
+
+        glm::vec3 light_center { light_view * glm::vec4 { center, 1.0f } };
+        const float texel = 2.0f * radius / float(resolution_);
+        light_center.x = std::floor(light_center.x / texel) * texel;
+        light_center.y = std::floor(light_center.y / texel) * texel;
+        light_center.z = std::floor(light_center.z / texel) * texel;
+
+        const glm::vec2 min { light_center.x - radius, light_center.y - radius };
+        const glm::vec2 max { light_center.x + radius, light_center.y + radius };
+
+        // The light looks down -z, so the near plane is the highest z.
+        // Only receivers inside the sphere need to be covered, but every
+        // caster overlapping the cascade between them and the light has to
+        // be in range. Without any, the light side of the sphere is used.
+        const float far_z = light_center.z - radius;
+        float near_z = std::numeric_limits<float>::lowest();
+        for (std::size_t i = 0; i < caster_min.size(); ++i) {
+            if (caster_max[i].x < min.x || caster_min[i].x > max.x || caster_max[i].y < min.y || caster_min[i].y > max.y || caster_max[i].z < far_z)
+                continue;
+            near_z = std::max(near_z, caster_max[i].z);
+        }
+        if (near_z == std::numeric_limits<float>::lowest())
+            near_z = light_center.z + radius;
+        near_z = std::max(near_z, far_z + texel);
+
+        const glm::mat4 projection = glm::ortho(min.x, max.x, min.y, max.y, -near_z, -far_z);
+        block_.light_projection_view_matrix[cascade] = projection * light_view;
+
+        // Plane parallel to the camera far plane through the end of the
+        // slice, positive for points closer to the camera.
+        const glm::vec3 normal { far_plane };
+        block_.light_frustum_far_plane[cascade] = glm::vec4 { normal, -glm::dot(normal, corners[4]) };
+    }
+}
+}
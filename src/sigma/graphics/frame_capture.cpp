@@ -0,0 +1,101 @@
+#include <sigma/graphics/frame_capture.hpp>
+
+#include <cereal/archives/binary.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace sigma {
+namespace graphics {
+    std::map<std::uint64_t, std::string>& resource_keys::of(resource_kind kind)
+    {
+        switch (kind) {
+        case resource_kind::program:
+            return programs;
+        case resource_kind::buffer:
+            return buffers;
+        case resource_kind::texture:
+            return textures;
+        case resource_kind::mesh:
+            break;
+        }
+        return meshes;
+    }
+
+    frame_capture frame_capture::capture(const render_queue& queue, const view_port& view, const resource_resolver& resolve)
+    {
+        frame_capture result;
+        result.size = view.size;
+        result.view = view.view_frustum.view();
+        result.projection = view.view_frustum.projection();
+        result.keys.reserve(queue.size());
+        result.commands.reserve(queue.size());
+        result.views = queue.views();
+        for (const auto& e : queue.entries()) {
+            result.keys.push_back(e.key);
+            result.commands.push_back(queue.command(e));
+        }
+
+        if (resolve) {
+            // Ids that do not resolve are kept as empty keys until every
+            // command was visited so they are only looked up once.
+            auto add = [&](resource_kind kind, std::uint64_t id) {
+                auto& keys = result.resources.of(kind);
+                if (!keys.count(id))
+                    keys.emplace(id, resolve(kind, id));
+            };
+            for (const auto& cmd : result.commands) {
+                add(resource_kind::program, cmd.program);
+                for (auto id : cmd.buffer_bindings)
+                    add(resource_kind::buffer, id);
+                for (auto id : cmd.input_textures)
+                    add(resource_kind::texture, id);
+                add(resource_kind::mesh, cmd.mesh);
+            }
+
+            for (auto kind : { resource_kind::program, resource_kind::buffer, resource_kind::texture, resource_kind::mesh }) {
+                auto& keys = result.resources.of(kind);
+                for (auto it = keys.begin(); it != keys.end();)
+                    it = it->second.empty() ? keys.erase(it) : std::next(it);
+            }
+        }
+        return result;
+    }
+
+    frame_capture frame_capture::load(const std::filesystem::path& path)
+    {
+        std::ifstream file { path.string(), std::ios::binary | std::ios::in };
+        if (!file)
+            throw std::runtime_error("could not open frame capture " + path.string());
+
+        frame_capture result;
+        cereal::BinaryInputArchive ia(file);
+        ia(result);
+        return result;
+    }
+
+    void frame_capture::save(const std::filesystem::path& path) const
+    {
+        std::ofstream file { path.string(), std::ios::binary | std::ios::out };
+        if (!file)
+            throw std::runtime_error("could not create frame capture " + path.string());
+
+        cereal::BinaryOutputArchive oa(file);
+        oa(*this);
+    }
+
+    void frame_capture::replay(render_queue& queue) const
+    {
+        for (const auto& block : views)
+            queue.add_view(block);
+        for (std::size_t i = 0; i < commands.size(); ++i)
+            *queue.enqueue(keys[i]) = commands[i];
+    }
+
+    void frame_capture::replay(renderer& target) const
+    {
+        replay(*target.queue());
+    }
+}
+}
@@ -0,0 +1,335 @@
+#include <sigma/graphics/frame_graph.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sigma {
+namespace graphics {
+    namespace {
+        constexpr std::size_t UNUSED = std::numeric_limits<std::size_t>::max();
+
+        std::size_t align(std::size_t value)
+        {
+            return (value + frame_graph::ALIGNMENT - 1) / frame_graph::ALIGNMENT * frame_graph::ALIGNMENT;
+        }
+
+        void add_unique(std::vector<std::uint32_t>& values, std::uint32_t value)
+        {
+            if (std::find(values.begin(), values.end(), value) == values.end())
+                values.push_back(value);
+        }
+    }
+
+    frame_graph::builder::builder(frame_graph& graph, pass_handle pass)
+        : graph_(graph)
+        , pass_(pass)
+    {
+    }
+
+    frame_graph::resource_handle frame_graph::builder::create_texture(const std::string& name, glm::ivec2 size, std::uint32_t bytes_per_pixel)
+    {
+        auto resource = graph_.add_resource_(name, std::size_t(size.x) * std::size_t(size.y) * bytes_per_pixel, false);
+        write(resource);
+        return resource;
+    }
+
+    frame_graph::resource_handle frame_graph::builder::create_buffer(const std::string& name, std::size_t size)
+    {
+        auto resource = graph_.add_resource_(name, size, false);
+        write(resource);
+        return resource;
+    }
+
+    void frame_graph::builder::read(resource_handle resource)
+    {
+        if (resource >= graph_.resources_.size())
+            throw std::out_of_range("frame_graph resource handle out of range");
+        add_unique(graph_.passes_[pass_].reads, resource);
+    }
+
+    void frame_graph::builder::write(resource_handle resource)
+    {
+        if (resource >= graph_.resources_.size())
+            throw std::out_of_range("frame_graph resource handle out of range");
+        add_unique(graph_.passes_[pass_].writes, resource);
+    }
+
+    void frame_graph::builder::side_effect()
+    {
+        graph_.passes_[pass_].side_effect = true;
+    }
+
+    frame_graph::resource_handle frame_graph::import(const std::string& name)
+    {
+        return add_resource_(name, 0, true);
+    }
+
+    frame_graph::pass_handle frame_graph::add_pass(const std::string& name, const setup_function& setup, execute_function execute)
+    {
+        auto handle = static_cast<pass_handle>(passes_.size());
+        passes_.emplace_back();
+        passes_.back().name = name;
+        passes_.back().execute = std::move(execute);
+
+        builder b { *this, handle };
+        setup(b);
+        return handle;
+    }
+
+    void frame_graph::compile()
+    {
+        cull_();
+        link_();
+        allocate_();
+    }
+
+    void frame_graph::execute() const
+    {
+        for (auto handle : order_) {
+            if (passes_[handle].execute)
+                passes_[handle].execute(*this);
+        }
+    }
+
+    void frame_graph::clear()
+    {
+        passes_.clear();
+        resources_.clear();
+        order_.clear();
+        heap_size_ = 0;
+        unaliased_size_ = 0;
+    }
+
+    std::size_t frame_graph::pass_count() const noexcept
+    {
+        return passes_.size();
+    }
+
+    std::size_t frame_graph::resource_count() const noexcept
+    {
+        return resources_.size();
+    }
+
+    const std::string& frame_graph::pass_name(pass_handle pass) const
+    {
+        return passes_.at(pass).name;
+    }
+
+    const std::string& frame_graph::resource_name(resource_handle resource) const
+    {
+        return resources_.at(resource).name;
+    }
+
+    bool frame_graph::culled(pass_handle pass) const
+    {
+        return passes_.at(pass).culled;
+    }
+
+    const std::vector<frame_graph::pass_handle>& frame_graph::order() const noexcept
+    {
+        return order_;
+    }
+
+    const std::vector<frame_graph::pass_handle>& frame_graph::dependencies(pass_handle pass) const
+    {
+        return passes_.at(pass).dependencies;
+    }
+
+    std::size_t frame_graph::resource_size(resource_handle resource) const
+    {
+        return resources_.at(resource).size;
+    }
+
+    std::size_t frame_graph::heap_offset(resource_handle resource) const
+    {
+        return resources_.at(resource).offset;
+    }
+
+    std::size_t frame_graph::heap_size() const noexcept
+    {
+        return heap_size_;
+    }
+
+    std::size_t frame_graph::unaliased_size() const noexcept
+    {
+        return unaliased_size_;
+    }
+
+    frame_graph::resource_handle frame_graph::add_resource_(const std::string& name, std::size_t size, bool imported)
+    {
+        resources_.emplace_back();
+        resources_.back().name = name;
+        resources_.back().size = size;
+        resources_.back().imported = imported;
+        return static_cast<resource_handle>(resources_.size() - 1);
+    }
+
+    void frame_graph::cull_()
+    {
+        // Reference counting: a pass is referenced by the resources it
+        // writes, a resource by the passes reading it. Resources nobody
+        // reads release their writers, which release what they read.
+        for (auto& r : resources_) {
+            r.writers.clear();
+            r.references = r.imported ? 1 : 0;
+        }
+
+        std::vector<resource_handle> unreferenced;
+        for (pass_handle p = 0; p < passes_.size(); ++p) {
+            auto& current = passes_[p];
+            current.culled = false;
+            current.references = static_cast<std::uint32_t>(current.writes.size());
+            for (auto r : current.reads)
+                resources_[r].references++;
+            for (auto r : current.writes)
+                resources_[r].writers.push_back(p);
+        }
+
+        auto release = [&](pass& current) {
+            current.culled = true;
+            for (auto r : current.reads) {
+                if (--resources_[r].references == 0)
+                    unreferenced.push_back(r);
+            }
+        };
+
+        for (resource_handle r = 0; r < resources_.size(); ++r) {
+            if (resources_[r].references == 0)
+                unreferenced.push_back(r);
+        }
+        for (auto& current : passes_) {
+            if (current.references == 0 && !current.side_effect)
+                release(current);
+        }
+
+        while (!unreferenced.empty()) {
+            auto r = unreferenced.back();
+            unreferenced.pop_back();
+            for (auto p : resources_[r].writers) {
+                auto& writer = passes_[p];
+                if (!writer.culled && --writer.references == 0 && !writer.side_effect)
+                    release(writer);
+            }
+        }
+    }
+
+    void frame_graph::link_()
+    {
+        order_.clear();
+        for (pass_handle p = 0; p < passes_.size(); ++p) {
+            passes_[p].dependencies.clear();
+            if (!passes_[p].culled)
+                order_.push_back(p);
+        }
+
+        std::vector<std::size_t> last_writer(resources_.size(), UNUSED);
+        std::vector<std::vector<pass_handle>> readers(resources_.size());
+        for (auto& r : resources_) {
+            r.users.clear();
+            r.first_use = UNUSED;
+            r.last_use = 0;
+        }
+
+        for (std::size_t i = 0; i < order_.size(); ++i) {
+            auto p = order_[i];
+            auto& current = passes_[p];
+
+            // Read after write, write after write and write after read.
+            for (auto r : current.reads) {
+                if (last_writer[r] != UNUSED)
+                    add_unique(current.dependencies, static_cast<pass_handle>(last_writer[r]));
+            }
+            for (auto r : current.writes) {
+                if (last_writer[r] != UNUSED && last_writer[r] != p)
+                    add_unique(current.dependencies, static_cast<pass_handle>(last_writer[r]));
+                for (auto reader : readers[r]) {
+                    if (reader != p)
+                        add_unique(current.dependencies, reader);
+                }
+            }
+
+            for (auto r : current.reads)
+                readers[r].push_back(p);
+            for (auto r : current.writes) {
+                last_writer[r] = p;
+                readers[r].clear();
+            }
+
+            auto touch = [&](resource_handle r) {
+                add_unique(resources_[r].users, p);
+                resources_[r].first_use = std::min(resources_[r].first_use, i);
+                resources_[r].last_use = std::max(resources_[r].last_use, i);
+            };
+            for (auto r : current.reads)
+                touch(r);
+            for (auto r : current.writes)
+                touch(r);
+        }
+    }
+
+    void frame_graph::allocate_()
+    {
+        std::vector<resource_handle> transient;
+        for (resource_handle r = 0; r < resources_.size(); ++r) {
+            resources_[r].offset = NO_OFFSET;
+            if (!resources_[r].imported && resources_[r].first_use != UNUSED)
+                transient.push_back(r);
+        }
+
+        // Largest first, each resource goes to the lowest offset that does
+        // not overlap a placed resource alive at the same time.
+        std::stable_sort(transient.begin(), transient.end(), [this](resource_handle a, resource_handle b) {
+            return resources_[a].size > resources_[b].size;
+        });
+
+        heap_size_ = 0;
+        unaliased_size_ = 0;
+        std::vector<resource_handle> placed;
+        std::vector<std::pair<std::size_t, std::size_t>> occupied;
+        for (auto handle : transient) {
+            auto& r = resources_[handle];
+            const std::size_t size = align(r.size);
+
+            occupied.clear();
+            for (auto other : placed) {
+                const auto& o = resources_[other];
+                if (o.first_use <= r.last_use && r.first_use <= o.last_use)
+                    occupied.emplace_back(o.offset, o.offset + align(o.size));
+            }
+            std::sort(occupied.begin(), occupied.end());
+
+            std::size_t offset = 0;
+            for (const auto& range : occupied) {
+                if (offset + size <= range.first)
+                    break;
+                offset = std::max(offset, range.second);
+            }
+
+            r.offset = offset;
+            placed.push_back(handle);
+            heap_size_ = std::max(heap_size_, offset + size);
+            unaliased_size_ += size;
+        }
+
+        link_aliases_(placed);
+    }
+
+    void frame_graph::link_aliases_(const std::vector<resource_handle>& placed)
+    {
+        for (auto earlier : placed) {
+            const auto& e = resources_[earlier];
+            for (auto later : placed) {
+                const auto& l = resources_[later];
+                if (e.last_use >= l.first_use)
+                    continue;
+                if (e.offset >= l.offset + align(l.size) || l.offset >= e.offset + align(e.size))
+                    continue;
+
+                auto& first = passes_[order_[l.first_use]];
+                for (auto user : e.users)
+                    add_unique(first.dependencies, user);
+            }
+        }
+    }
+}
+}
@@ -0,0 +1,181 @@
+#include <sigma/graphics/frame_packet.hpp>
+
+#include <sigma/graphics/static_mesh_instance.hpp>
+#include <sigma/transform.hpp>
+
+#include <algorithm>
+
+namespace sigma {
+namespace graphics {
+    namespace {
+        using entity_type = frame_packet::entity_type;
+
+        // Appends the render components of one entity.
+        void extract_entity(entt::registry<>& registry, entity_type entity, frame_packet& packet)
+        {
+            if (registry.has<directional_light>(entity))
+                packet.directional_lights.push_back({ entity, registry.get<directional_light>(entity) });
+            if (!registry.has<transform>(entity))
+                return;
+
+            const auto& t = registry.get<transform>(entity);
+            if (registry.has<static_mesh_instance>(entity)) {
+                const auto& instance = registry.get<static_mesh_instance>(entity);
+                packet.meshes.push_back({ entity, t.matrix, instance.mesh, instance.cast_shadows });
+            }
+            if (registry.has<point_light>(entity))
+                packet.point_lights.push_back({ entity, affine::translation(t.matrix), registry.get<point_light>(entity) });
+            if (registry.has<spot_light>(entity))
+                packet.spot_lights.push_back({ entity, affine::translation(t.matrix), registry.get<spot_light>(entity) });
+        }
+
+        template <class T>
+        void upsert(std::vector<T>& list, std::unordered_map<entity_type, std::size_t>& indices, const T& value)
+        {
+            auto it = indices.find(value.entity);
+            if (it != indices.end()) {
+                list[it->second] = value;
+            } else {
+                indices[value.entity] = list.size();
+                list.push_back(value);
+            }
+        }
+
+        template <class T>
+        void erase(std::vector<T>& list, std::unordered_map<entity_type, std::size_t>& indices, entity_type entity)
+        {
+            auto it = indices.find(entity);
+            if (it == indices.end())
+                return;
+
+            const std::size_t index = it->second;
+            indices.erase(it);
+            if (index != list.size() - 1) {
+                list[index] = std::move(list.back());
+                indices[list[index].entity] = index;
+            }
+            list.pop_back();
+        }
+
+        template <class T>
+        void index(const std::vector<T>& list, std::unordered_map<entity_type, std::size_t>& indices)
+        {
+            indices.clear();
+            for (std::size_t i = 0; i < list.size(); ++i)
+                indices[list[i].entity] = i;
+        }
+    }
+
+    void frame_packet::clear()
+    {
+        incremental = false;
+        removed.clear();
+        meshes.clear();
+        point_lights.clear();
+        spot_lights.clear();
+        directional_lights.clear();
+    }
+
+    void extract(entt::registry<>& registry, const view_port& view, std::uint64_t frame, frame_packet& packet)
+    {
+        packet.clear();
+        packet.frame = frame;
+        packet.view = view;
+
+        auto meshes = registry.view<transform, static_mesh_instance>();
+        packet.meshes.reserve(meshes.size());
+        meshes.each([&](auto entity, const transform& t, const static_mesh_instance& instance) {
+            packet.meshes.push_back({ entity, t.matrix, instance.mesh, instance.cast_shadows });
+        });
+
+        registry.view<transform, point_light>().each([&](auto entity, const transform& t, const point_light& light) {
+            packet.point_lights.push_back({ entity, affine::translation(t.matrix), light });
+        });
+
+        registry.view<transform, spot_light>().each([&](auto entity, const transform& t, const spot_light& light) {
+            packet.spot_lights.push_back({ entity, affine::translation(t.matrix), light });
+        });
+
+        registry.view<directional_light>().each([&](auto entity, const directional_light& light) {
+            packet.directional_lights.push_back({ entity, light });
+        });
+
+        registry.reset<render_changed>();
+    }
+
+    void extract_changes(entt::registry<>& registry,
+        const view_port& view,
+        std::uint64_t frame,
+        const std::vector<frame_packet::entity_type>& moved,
+        const std::vector<frame_packet::entity_type>& destroyed,
+        frame_packet& packet)
+    {
+        packet.clear();
+        packet.incremental = true;
+        packet.frame = frame;
+        packet.view = view;
+
+        // Entities whose components changed are removed and extracted again
+        // so components taken off them disappear from the mirror.
+        std::vector<entity_type> changed;
+        registry.view<render_changed>().each([&](auto entity, const render_changed&) {
+            changed.push_back(entity);
+        });
+        registry.reset<render_changed>();
+
+        packet.removed = destroyed;
+        packet.removed.insert(packet.removed.end(), changed.begin(), changed.end());
+        for (auto entity : changed)
+            extract_entity(registry, entity, packet);
+
+        std::sort(changed.begin(), changed.end());
+        for (auto entity : moved) {
+            if (registry.valid(entity) && !std::binary_search(changed.begin(), changed.end(), entity))
+                extract_entity(registry, entity, packet);
+        }
+    }
+
+    void render_mirror::apply(const frame_packet& packet)
+    {
+        if (!packet.incremental) {
+            scene_ = packet;
+            rebuild_indices_();
+            return;
+        }
+
+        scene_.frame = packet.frame;
+        scene_.view = packet.view;
+        for (auto entity : packet.removed)
+            remove_(entity);
+        for (const auto& m : packet.meshes)
+            upsert(scene_.meshes, meshes_, m);
+        for (const auto& l : packet.point_lights)
+            upsert(scene_.point_lights, point_lights_, l);
+        for (const auto& l : packet.spot_lights)
+            upsert(scene_.spot_lights, spot_lights_, l);
+        for (const auto& l : packet.directional_lights)
+            upsert(scene_.directional_lights, directional_lights_, l);
+    }
+
+    const frame_packet& render_mirror::scene() const noexcept
+    {
+        return scene_;
+    }
+
+    void render_mirror::rebuild_indices_()
+    {
+        index(scene_.meshes, meshes_);
+        index(scene_.point_lights, point_lights_);
+        index(scene_.spot_lights, spot_lights_);
+        index(scene_.directional_lights, directional_lights_);
+    }
+
+    void render_mirror::remove_(entity_type entity)
+    {
+        erase(scene_.meshes, meshes_, entity);
+        erase(scene_.point_lights, point_lights_, entity);
+        erase(scene_.spot_lights, spot_lights_, entity);
+        erase(scene_.directional_lights, directional_lights_, entity);
+    }
+}
+}
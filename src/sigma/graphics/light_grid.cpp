@@ -0,0 +1,282 @@
+#include <sigma/graphics/light_grid.hpp>
+
+#include <sigma/util/numeric.hpp>
+#include <sigma/util/parallel.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace sigma {
+namespace graphics {
+    namespace {
+        constexpr std::size_t LANE_COUNT = 8;
+
+        struct sphere {
+            glm::vec3 center;
+            float radius;
+        };
+
+        struct cone {
+            glm::vec3 apex;
+            glm::vec3 direction;
+            float range;
+            float cos_angle;
+            float sin_angle;
+        };
+    }
+
+    light_grid::light_grid(glm::uvec3 dimensions)
+    {
+        set_dimensions(dimensions);
+    }
+
+    glm::uvec3 light_grid::dimensions() const noexcept
+    {
+        return dimensions_;
+    }
+
+    void light_grid::set_dimensions(glm::uvec3 dimensions)
+    {
+        dimensions_ = glm::max(dimensions, glm::uvec3 { 1 });
+        lane_stride_ = numeric::round_up<std::size_t>(dimensions_.x * dimensions_.y, LANE_COUNT);
+
+        const std::size_t padded = lane_stride_ * dimensions_.z;
+        for (auto* bounds : { &min_x_, &min_y_, &min_z_, &max_x_, &max_y_, &max_z_ })
+            bounds->assign(padded, 0.0f);
+
+        slice_points_.resize(dimensions_.z);
+        slice_spots_.resize(dimensions_.z);
+
+        // Forces the bounds to be rebuilt.
+        z_near_ = z_far_ = 0.0f;
+    }
+
+    void light_grid::build(frame_allocator& frames, const frustum& view, const std::vector<frame_packet::point_light_instance>& point_lights, const std::vector<frame_packet::spot_light_instance>& spot_lights)
+    {
+        if (frames.thread_count() < util::worker_count())
+            throw std::invalid_argument("light_grid needs a frame_allocator sub-arena for every worker");
+
+        if (z_near_ != view.z_near() || z_far_ != view.z_far() || !(projection_ == view.projection()))
+            build_bounds_(view);
+
+        const glm::mat4 view_matrix = view.view();
+        std::vector<sphere> spheres(point_lights.size());
+        for (std::size_t i = 0; i < point_lights.size(); ++i)
+            spheres[i] = { glm::vec3 { view_matrix * glm::vec4 { point_lights[i].position, 1.0f } }, point_lights[i].light.range };
+
+        std::vector<cone> cones(spot_lights.size());
+        for (std::size_t i = 0; i < spot_lights.size(); ++i) {
+            const auto& light = spot_lights[i].light;
+            cones[i] = {
+                glm::vec3 { view_matrix * glm::vec4 { spot_lights[i].position, 1.0f } },
+                glm::normalize(glm::vec3 { view_matrix * glm::vec4 { light.direction, 0.0f } }),
+                light.range,
+                std::cos(light.cutoff),
+                std::sin(light.cutoff)
+            };
+        }
+
+        const std::size_t slice_size = std::size_t(dimensions_.x) * dimensions_.y;
+        clusters_ = frame_vector<cluster>(slice_size * dimensions_.z, cluster {}, arena_allocator<cluster> { frames });
+        util::parallel_for(dimensions_.z, 1, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+            frame_vector<std::uint32_t> candidates { arena_allocator<std::uint32_t> { frames, worker } };
+            for (std::size_t slice = begin; slice < end; ++slice) {
+                const float near_depth = slice_depth_(std::uint32_t(slice));
+                const float far_depth = slice_depth_(std::uint32_t(slice + 1));
+                const std::size_t first = slice * lane_stride_;
+                cluster* slice_clusters = clusters_.data() + slice * slice_size;
+                auto& points = slice_points_[slice] = frame_vector<hit> { arena_allocator<hit> { frames, worker } };
+                auto& spots = slice_spots_[slice] = frame_vector<hit> { arena_allocator<hit> { frames, worker } };
+
+                // Only lights reaching the depth range of the slice are
+                // tested against its clusters.
+                candidates.clear();
+                for (std::uint32_t l = 0; l < spheres.size(); ++l) {
+                    const float depth = -spheres[l].center.z;
+                    if (depth + spheres[l].radius >= near_depth && depth - spheres[l].radius <= far_depth)
+                        candidates.push_back(l);
+                }
+
+                for (std::size_t lane0 = 0; lane0 < slice_size; lane0 += LANE_COUNT) {
+                    const std::size_t b = first + lane0;
+                    for (auto l : candidates) {
+                        const sphere& s = spheres[l];
+                        bool inside[LANE_COUNT];
+                        for (std::size_t lane = 0; lane < LANE_COUNT; ++lane) {
+                            const float dx = s.center.x - std::min(std::max(s.center.x, min_x_[b + lane]), max_x_[b + lane]);
+                            const float dy = s.center.y - std::min(std::max(s.center.y, min_y_[b + lane]), max_y_[b + lane]);
+                            const float dz = s.center.z - std::min(std::max(s.center.z, min_z_[b + lane]), max_z_[b + lane]);
+                            inside[lane] = dx * dx + dy * dy + dz * dz <= s.radius * s.radius;
+                        }
+                        for (std::size_t lane = 0; lane < LANE_COUNT && lane0 + lane < slice_size; ++lane) {
+                            if (inside[lane]) {
+                                points.push_back({ std::uint32_t(lane0 + lane), l });
+                                slice_clusters[lane0 + lane].point_count++;
+                            }
+                        }
+                    }
+                }
+
+                candidates.clear();
+                for (std::uint32_t l = 0; l < cones.size(); ++l) {
+                    const float depth = -cones[l].apex.z;
+                    if (depth + cones[l].range >= near_depth && depth - cones[l].range <= far_depth)
+                        candidates.push_back(l);
+                }
+
+                for (std::size_t lane0 = 0; lane0 < slice_size; lane0 += LANE_COUNT) {
+                    const std::size_t b = first + lane0;
+                    for (auto l : candidates) {
+                        const cone& c = cones[l];
+                        bool inside[LANE_COUNT];
+                        for (std::size_t lane = 0; lane < LANE_COUNT; ++lane) {
+                            // Cone against the bounding sphere of the cluster.
+                            const glm::vec3 min { min_x_[b + lane], min_y_[b + lane], min_z_[b + lane] };
+                            const glm::vec3 max { max_x_[b + lane], max_y_[b + lane], max_z_[b + lane] };
+                            const glm::vec3 center = (min + max) * 0.5f;
+                            const float radius = glm::length(max - min) * 0.5f;
+
+                            const glm::vec3 v = center - c.apex;
+                            const float length_squared = glm::dot(v, v);
+                            const float along = glm::dot(v, c.direction);
+                            const float across = std::sqrt(std::max(length_squared - along * along, 0.0f));
+                            const float distance = c.cos_angle * across - along * c.sin_angle;
+                            inside[lane] = !(distance > radius || along > radius + c.range || along < -radius);
+                        }
+                        for (std::size_t lane = 0; lane < LANE_COUNT && lane0 + lane < slice_size; ++lane) {
+                            if (inside[lane]) {
+                                spots.push_back({ std::uint32_t(lane0 + lane), l });
+                                slice_clusters[lane0 + lane].spot_count++;
+                            }
+                        }
+                    }
+                }
+            }
+        });
+
+        std::uint32_t offset = 0;
+        for (auto& c : clusters_) {
+            c.offset = offset;
+            offset += c.point_count + c.spot_count;
+        }
+
+        // Hits are in light order within each cluster, scattering points
+        // first and spots second keeps both ranges sorted.
+        indices_ = frame_vector<std::uint32_t>(offset, arena_allocator<std::uint32_t> { frames });
+        util::parallel_for(dimensions_.z, 1, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+            frame_vector<std::uint32_t> cursors { arena_allocator<std::uint32_t> { frames, worker } };
+            for (std::size_t slice = begin; slice < end; ++slice) {
+                const cluster* slice_clusters = clusters_.data() + slice * slice_size;
+                cursors.resize(slice_size);
+                for (std::size_t i = 0; i < slice_size; ++i)
+                    cursors[i] = slice_clusters[i].offset;
+                for (const auto& h : slice_points_[slice])
+                    indices_[cursors[h.cluster]++] = h.light;
+                for (const auto& h : slice_spots_[slice])
+                    indices_[cursors[h.cluster]++] = h.light;
+            }
+        });
+    }
+
+    void light_grid::build(frame_allocator& frames, const frustum& view, const frame_packet& packet)
+    {
+        build(frames, view, packet.point_lights, packet.spot_lights);
+    }
+
+    std::size_t light_grid::cluster_index(glm::uvec3 cell) const noexcept
+    {
+        return (std::size_t(cell.z) * dimensions_.y + cell.y) * dimensions_.x + cell.x;
+    }
+
+    std::size_t light_grid::cluster_at(const glm::vec3& view_position) const
+    {
+        const glm::vec4 clip = projection_ * glm::vec4 { view_position, 1.0f };
+        const glm::vec2 ndc = glm::vec2 { clip } / clip.w;
+        const float depth = -view_position.z;
+
+        auto cell = [](float t, std::uint32_t count) {
+            return std::uint32_t(std::min(std::max(std::floor(t * float(count)), 0.0f), float(count - 1)));
+        };
+        return cluster_index({ cell((ndc.x + 1.0f) * 0.5f, dimensions_.x),
+            cell((ndc.y + 1.0f) * 0.5f, dimensions_.y),
+            cell(std::log(depth / z_near_) / std::log(z_far_ / z_near_), dimensions_.z) });
+    }
+
+    const frame_vector<light_grid::cluster>& light_grid::clusters() const noexcept
+    {
+        return clusters_;
+    }
+
+    const frame_vector<std::uint32_t>& light_grid::indices() const noexcept
+    {
+        return indices_;
+    }
+
+    float light_grid::slice_depth_(std::uint32_t slice) const noexcept
+    {
+        return z_near_ * std::pow(z_far_ / z_near_, float(slice) / float(dimensions_.z));
+    }
+
+    void light_grid::build_bounds_(const frustum& view)
+    {
+        projection_ = view.projection();
+        z_near_ = view.z_near();
+        z_far_ = view.z_far();
+
+        // Padding lanes get empty boxes that no light reaches.
+        std::fill(min_x_.begin(), min_x_.end(), std::numeric_limits<float>::max());
+        std::fill(min_y_.begin(), min_y_.end(), std::numeric_limits<float>::max());
+        std::fill(min_z_.begin(), min_z_.end(), std::numeric_limits<float>::max());
+        std::fill(max_x_.begin(), max_x_.end(), std::numeric_limits<float>::lowest());
+        std::fill(max_y_.begin(), max_y_.end(), std::numeric_limits<float>::lowest());
+        std::fill(max_z_.begin(), max_z_.end(), std::numeric_limits<float>::lowest());
+
+        const glm::mat4 inverse = view.inverse_projection();
+        auto unproject = [&](float x, float y, float z) {
+            const glm::vec4 p = inverse * glm::vec4 { x, y, z, 1.0f };
+            return glm::vec3 { p } / p.w;
+        };
+
+        for (std::uint32_t y = 0; y < dimensions_.y; ++y) {
+            for (std::uint32_t x = 0; x < dimensions_.x; ++x) {
+                // The four corner rays of the tile from the near to the far
+                // plane, cut at the depth of each slice boundary.
+                glm::vec3 near_points[4];
+                glm::vec3 far_points[4];
+                for (int corner = 0; corner < 4; ++corner) {
+                    const float ndc_x = -1.0f + 2.0f * float(x + (corner & 1)) / float(dimensions_.x);
+                    const float ndc_y = -1.0f + 2.0f * float(y + (corner >> 1)) / float(dimensions_.y);
+                    near_points[corner] = unproject(ndc_x, ndc_y, -1.0f);
+                    far_points[corner] = unproject(ndc_x, ndc_y, 1.0f);
+                }
+
+                for (std::uint32_t slice = 0; slice < dimensions_.z; ++slice) {
+                    glm::vec3 min { std::numeric_limits<float>::max() };
+                    glm::vec3 max { std::numeric_limits<float>::lowest() };
+                    for (float depth : { slice_depth_(slice), slice_depth_(slice + 1) }) {
+                        for (int corner = 0; corner < 4; ++corner) {
+                            const glm::vec3 ray = far_points[corner] - near_points[corner];
+                            const float t = (-depth - near_points[corner].z) / ray.z;
+                            const glm::vec3 p = near_points[corner] + ray * t;
+                            min = glm::min(min, p);
+                            max = glm::max(max, p);
+                        }
+                    }
+
+                    const std::size_t i = slice * lane_stride_ + y * dimensions_.x + x;
+                    min_x_[i] = min.x;
+                    min_y_[i] = min.y;
+                    min_z_[i] = min.z;
+                    max_x_[i] = max.x;
+                    max_y_[i] = max.y;
+                    max_z_[i] = max.z;
+                }
+            }
+        }
+    }
+}
+}
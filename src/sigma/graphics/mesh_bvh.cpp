@@ -0,0 +1,113 @@
+#include <sigma/graphics/mesh_bvh.hpp>
+
+#include <sigma/util/parallel.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <cmath>
+
+namespace sigma {
+namespace graphics {
+    namespace {
+        constexpr float EPSILON = 1e-8f;
+    }
+
+    mesh_bvh::mesh_bvh(std::weak_ptr<sigma::context> ctx, resource::key_type key)
+        : resource::base_resource::base_resource(std::move(ctx), std::move(key))
+    {
+    }
+
+    void mesh_bvh::build(const static_mesh& mesh)
+    {
+        const auto& vertices = mesh.vertices();
+        const auto& triangles = mesh.triangles();
+
+        std::vector<glm::vec3> min(triangles.size());
+        std::vector<glm::vec3> max(triangles.size());
+        corners_.resize(triangles.size());
+        edges1_.resize(triangles.size());
+        edges2_.resize(triangles.size());
+        util::parallel_for(triangles.size(), 16384, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const glm::vec3& p0 = vertices[triangles[i][0]].position;
+                const glm::vec3& p1 = vertices[triangles[i][1]].position;
+                const glm::vec3& p2 = vertices[triangles[i][2]].position;
+                corners_[i] = p0;
+                edges1_[i] = p1 - p0;
+                edges2_[i] = p2 - p0;
+                min[i] = glm::min(glm::min(p0, p1), p2);
+                max[i] = glm::max(glm::max(p0, p1), p2);
+            }
+        });
+
+        tree_.build(min, max);
+    }
+
+    std::size_t mesh_bvh::size() const noexcept
+    {
+        return corners_.size();
+    }
+
+    const bvh& mesh_bvh::tree() const noexcept
+    {
+        return tree_;
+    }
+
+    bool mesh_bvh::closest_hit(const glm::vec3& origin, const glm::vec3& direction, float max_distance, hit& result) const
+    {
+        result = hit {};
+        bool found = false;
+        tree_.raycast(origin, direction, max_distance, [&](std::uint32_t triangle, float& distance) {
+            found |= intersect_(triangle, origin, direction, distance, result);
+        });
+        return found;
+    }
+
+    bool mesh_bvh::any_hit(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const
+    {
+        const glm::vec3 inv_direction = 1.0f / direction;
+        bool found = false;
+        hit ignored;
+        tree_.traverse(0,
+            [&](const bvh::node& n, std::uint64_t&) {
+                return !found && bvh::intersects(origin, inv_direction, max_distance, n.min, n.max);
+            },
+            [&](std::uint32_t triangle, std::uint64_t) {
+                if (!found)
+                    found = intersect_(triangle, origin, direction, max_distance, ignored);
+            });
+        return found;
+    }
+
+    bool mesh_bvh::intersect_(std::uint32_t triangle, const glm::vec3& origin, const glm::vec3& direction, float& max_distance, hit& result) const noexcept
+    {
+        const glm::vec3& e1 = edges1_[triangle];
+        const glm::vec3& e2 = edges2_[triangle];
+        const glm::vec3 p = glm::cross(direction, e2);
+        const float determinant = glm::dot(e1, p);
+        if (std::abs(determinant) < EPSILON)
+            return false;
+
+        const float inv_determinant = 1.0f / determinant;
+        const glm::vec3 s = origin - corners_[triangle];
+        const float u = glm::dot(s, p) * inv_determinant;
+        if (u < 0.0f || u > 1.0f)
+            return false;
+
+        const glm::vec3 q = glm::cross(s, e1);
+        const float v = glm::dot(direction, q) * inv_determinant;
+        if (v < 0.0f || u + v > 1.0f)
+            return false;
+
+        const float t = glm::dot(e2, q) * inv_determinant;
+        if (t < 0.0f || t > max_distance)
+            return false;
+
+        max_distance = t;
+        result.triangle = triangle;
+        result.distance = t;
+        result.barycentric = { u, v };
+        return true;
+    }
+}
+}
@@ -0,0 +1,115 @@
+#include <sigma/graphics/null_renderer.hpp>
+
+#include <cstring>
+
+namespace sigma {
+namespace graphics {
+    namespace {
+        using clock = std::chrono::steady_clock;
+
+        template <class F>
+        std::chrono::nanoseconds time(F&& f)
+        {
+            auto start = clock::now();
+            f();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+        }
+    }
+
+    null_renderer::null_renderer(glm::ivec2 size, std::shared_ptr<sigma::context> ctx)
+        : renderer(size, ctx)
+        , size_(size)
+        , queue_(0)
+    {
+    }
+
+    render_queue* null_renderer::queue()
+    {
+        return &queue_;
+    }
+
+    void null_renderer::resize(glm::uvec2 size)
+    {
+        size_ = size;
+    }
+
+    void null_renderer::render()
+    {
+        auto start = clock::now();
+        auto& frames = context_->render_memory();
+
+        timings_.sort = time([&] {
+            queue_.merge();
+            queue_.sort();
+        });
+        timings_.batch = time([&] { queue_.build_batches(); });
+        timings_.state = time([&] { stream_.build(queue_); });
+
+        timings_.pack = time([&] {
+            view_stride_ = pack_std140(queue_.views().data(), queue_.views().size(), UNIFORM_ALIGNMENT, view_uniforms_);
+
+            const auto& batches = queue_.batches();
+            const auto& instances = queue_.instances();
+            const std::size_t draw_size = batches.size() * sizeof(draw_block);
+            uniforms_ = frame_vector<std::byte>(draw_size + instances.size() * sizeof(affine::matrix), arena_allocator<std::byte> { frames });
+
+            auto out = uniforms_.data();
+            for (const auto& b : batches) {
+                draw_block block { b.instance_offset, b.instance_count, { 0, 0 } };
+                std::memcpy(out, &block, sizeof(block));
+                out += sizeof(block);
+            }
+            if (!instances.empty())
+                std::memcpy(out, instances.data(), instances.size() * sizeof(affine::matrix));
+        });
+
+        timings_.submit = time([&] {
+            recorded_.assign(stream_.changes().begin(), stream_.changes().end());
+        });
+
+        queue_.clear();
+        frame_count_++;
+        timings_.total = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+    }
+
+    glm::uvec2 null_renderer::size() const noexcept
+    {
+        return size_;
+    }
+
+    std::uint64_t null_renderer::frame_count() const noexcept
+    {
+        return frame_count_;
+    }
+
+    const null_renderer::stage_timings& null_renderer::timings() const noexcept
+    {
+        return timings_;
+    }
+
+    const state_stream::statistics& null_renderer::stats() const noexcept
+    {
+        return stream_.stats();
+    }
+
+    const std::vector<state_change>& null_renderer::recorded() const noexcept
+    {
+        return recorded_;
+    }
+
+    const frame_vector<std::byte>& null_renderer::uniforms() const noexcept
+    {
+        return uniforms_;
+    }
+
+    const std::vector<std::byte>& null_renderer::view_uniforms() const noexcept
+    {
+        return view_uniforms_;
+    }
+
+    std::size_t null_renderer::view_stride() const noexcept
+    {
+        return view_stride_;
+    }
+}
+}
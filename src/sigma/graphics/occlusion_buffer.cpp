@@ -0,0 +1,242 @@
+#include <sigma/graphics/occlusion_buffer.hpp>
+
+#include <sigma/graphics/rasterizer.hpp>
+#include <sigma/util/parallel.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sigma {
+namespace graphics {
+    occlusion_buffer::occlusion_buffer(glm::ivec2 size)
+    {
+        resize(size);
+    }
+
+    glm::ivec2 occlusion_buffer::size() const noexcept
+    {
+        return size_;
+    }
+
+    void occlusion_buffer::resize(glm::ivec2 size)
+    {
+        size_ = size;
+        tile_count_ = (size + TILE_SIZE - 1) / TILE_SIZE;
+        bins_.resize(tile_count_.x * tile_count_.y);
+
+        // Level zero is padded to whole tiles so every tile row can be
+        // processed in full lanes, the padding stays at the far plane.
+        level_sizes_.clear();
+        levels_.clear();
+        glm::ivec2 level_size = tile_count_ * TILE_SIZE;
+        while (true) {
+            level_sizes_.push_back(level_size);
+            levels_.emplace_back(level_size.x * level_size.y, 1.0f);
+            if (level_size.x == 1 && level_size.y == 1)
+                break;
+            level_size = glm::max((level_size + 1) / 2, glm::ivec2 { 1 });
+        }
+    }
+
+    void occlusion_buffer::begin(const glm::mat4& projection_view)
+    {
+        projection_view_ = projection_view;
+        triangles_.clear();
+        for (auto& bin : bins_)
+            bin.clear();
+        std::fill(levels_[0].begin(), levels_[0].end(), 1.0f);
+    }
+
+    void occlusion_buffer::add_occluder(const static_mesh& mesh, const glm::mat4& model)
+    {
+        const glm::mat4 mvp = projection_view_ * model;
+        const auto& vertices = mesh.vertices();
+
+        std::vector<glm::vec4> clip(vertices.size());
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+            clip[i] = mvp * glm::vec4 { vertices[i].position, 1.0f };
+
+        for (const auto& tri : mesh.triangles())
+            add_triangle_(clip[tri[0]], clip[tri[1]], clip[tri[2]]);
+    }
+
+    void occlusion_buffer::add_occluder(const std::vector<glm::vec3>& positions, const std::vector<static_mesh::triangle>& triangles, const glm::mat4& model)
+    {
+        const glm::mat4 mvp = projection_view_ * model;
+
+        std::vector<glm::vec4> clip(positions.size());
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            clip[i] = mvp * glm::vec4 { positions[i], 1.0f };
+
+        for (const auto& tri : triangles)
+            add_triangle_(clip[tri[0]], clip[tri[1]], clip[tri[2]]);
+    }
+
+    void occlusion_buffer::render()
+    {
+        util::parallel_for(bins_.size(), 1, [this](std::size_t begin, std::size_t end) {
+            for (std::size_t tile = begin; tile < end; ++tile)
+                rasterize_tile_(static_cast<int>(tile));
+        });
+        build_hierarchy_();
+    }
+
+    bool occlusion_buffer::is_visible(const glm::vec3& min, const glm::vec3& max) const
+    {
+        glm::vec2 screen_min { std::numeric_limits<float>::max() };
+        glm::vec2 screen_max { std::numeric_limits<float>::lowest() };
+        float nearest = std::numeric_limits<float>::max();
+        for (int i = 0; i < 8; ++i) {
+            glm::vec4 corner { (i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z, 1.0f };
+            glm::vec4 clip = projection_view_ * corner;
+
+            // Bounds crossing the near plane can not be tested reliably.
+            if (clip.w <= rasterizer::MIN_W)
+                return true;
+
+            glm::vec3 ndc = glm::vec3 { clip } / clip.w;
+            glm::vec2 screen = (glm::vec2 { ndc.x, ndc.y } * 0.5f + 0.5f) * glm::vec2 { size_ };
+            screen_min = glm::min(screen_min, screen);
+            screen_max = glm::max(screen_max, screen);
+            nearest = std::min(nearest, ndc.z * 0.5f + 0.5f);
+        }
+
+        if (nearest <= 0.0f)
+            return true;
+
+        if (screen_max.x < 0 || screen_max.y < 0 || screen_min.x >= size_.x || screen_min.y >= size_.y)
+            return false;
+
+        glm::ivec2 lo = glm::clamp(glm::ivec2 { glm::floor(screen_min) }, glm::ivec2 { 0 }, size_ - 1);
+        glm::ivec2 hi = glm::clamp(glm::ivec2 { glm::floor(screen_max) }, glm::ivec2 { 0 }, size_ - 1);
+
+        // Pick the level where the bounds cover at most 4x4 texels.
+        std::size_t level = 0;
+        while (level + 1 < levels_.size() && ((hi.x >> level) - (lo.x >> level) > 3 || (hi.y >> level) - (lo.y >> level) > 3))
+            level++;
+
+        const auto& depths = levels_[level];
+        const int stride = level_sizes_[level].x;
+        for (int y = lo.y >> level; y <= hi.y >> level; ++y) {
+            for (int x = lo.x >> level; x <= hi.x >> level; ++x) {
+                if (nearest <= depths[y * stride + x])
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    bool occlusion_buffer::is_visible(const AABB& bounds) const
+    {
+        return is_visible(bounds.min(), bounds.max());
+    }
+
+    std::size_t occlusion_buffer::level_count() const noexcept
+    {
+        return levels_.size();
+    }
+
+    glm::ivec2 occlusion_buffer::level_size(std::size_t level) const
+    {
+        return level_sizes_[level];
+    }
+
+    float occlusion_buffer::depth(std::size_t level, glm::ivec2 pixel) const
+    {
+        return levels_[level][pixel.y * level_sizes_[level].x + pixel.x];
+    }
+
+    void occlusion_buffer::add_triangle_(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2)
+    {
+        // Triangles crossing the near plane are dropped rather than clipped,
+        // leaving out part of an occluder only makes the test more conservative.
+        if (c0.w <= rasterizer::MIN_W || c1.w <= rasterizer::MIN_W || c2.w <= rasterizer::MIN_W)
+            return;
+
+        const glm::vec2 half_size = glm::vec2 { size_ } * 0.5f;
+        auto to_screen = [&](const glm::vec4& c) {
+            glm::vec3 ndc = glm::vec3 { c } / c.w;
+            return glm::vec3 { (ndc.x + 1.0f) * half_size.x, (ndc.y + 1.0f) * half_size.y, ndc.z * 0.5f + 0.5f };
+        };
+
+        screen_triangle tri { to_screen(c0), to_screen(c1), to_screen(c2) };
+        if (tri.v0.z < 0 || tri.v1.z < 0 || tri.v2.z < 0)
+            return;
+        if (tri.v0.z > 1 && tri.v1.z > 1 && tri.v2.z > 1)
+            return;
+
+        glm::ivec2 first_tile, last_tile;
+        if (!rasterizer::is_front_facing(tri.v0, tri.v1, tri.v2) || !rasterizer::tile_range(tri.v0, tri.v1, tri.v2, size_, TILE_SIZE, tile_count_, first_tile, last_tile))
+            return;
+
+        auto index = static_cast<std::uint32_t>(triangles_.size());
+        triangles_.push_back(tri);
+        for (int y = first_tile.y; y <= last_tile.y; ++y) {
+            for (int x = first_tile.x; x <= last_tile.x; ++x)
+                bins_[y * tile_count_.x + x].push_back(index);
+        }
+    }
+
+    void occlusion_buffer::rasterize_tile_(int tile)
+    {
+        const glm::ivec2 origin = glm::ivec2 { tile % tile_count_.x, tile / tile_count_.x } * TILE_SIZE;
+        const int stride = level_sizes_[0].x;
+        auto& depths = levels_[0];
+
+        for (auto index : bins_[tile]) {
+            const auto& tri = triangles_[index];
+            const rasterizer::edge e0 { tri.v1, tri.v2 };
+            const rasterizer::edge e1 { tri.v2, tri.v0 };
+            const rasterizer::edge e2 { tri.v0, tri.v1 };
+
+            // Depth as a plane over the screen so it can be stepped like the edges.
+            const float inverse_area = 1.0f / e2(tri.v2.x, tri.v2.y);
+            const float za = (e0.a * tri.v0.z + e1.a * tri.v1.z + e2.a * tri.v2.z) * inverse_area;
+            const float zb = (e0.b * tri.v0.z + e1.b * tri.v1.z + e2.b * tri.v2.z) * inverse_area;
+            const float zc = (e0.c * tri.v0.z + e1.c * tri.v1.z + e2.c * tri.v2.z) * inverse_area;
+
+            glm::vec2 min, max;
+            rasterizer::screen_bounds(tri.v0, tri.v1, tri.v2, min, max);
+            const int x_begin = std::max(origin.x, static_cast<int>(std::floor(min.x))) & ~(rasterizer::LANE_COUNT - 1);
+            const int x_end = std::min(origin.x + TILE_SIZE, static_cast<int>(std::ceil(max.x)));
+            const int y_begin = std::max(origin.y, static_cast<int>(std::floor(min.y)));
+            const int y_end = std::min(origin.y + TILE_SIZE, static_cast<int>(std::ceil(max.y)));
+
+            for (int y = y_begin; y < y_end; ++y) {
+                const float py = y + 0.5f;
+                float* row = depths.data() + y * stride;
+                for (int x = x_begin; x < x_end; x += rasterizer::LANE_COUNT) {
+                    for (int lane = 0; lane < rasterizer::LANE_COUNT; ++lane) {
+                        const float px = x + lane + 0.5f;
+                        const bool inside = e0.covers(e0(px, py)) & e1.covers(e1(px, py)) & e2.covers(e2(px, py));
+                        const float z = za * px + zb * py + zc;
+                        row[x + lane] = inside ? std::min(row[x + lane], z) : row[x + lane];
+                    }
+                }
+            }
+        }
+    }
+
+    void occlusion_buffer::build_hierarchy_()
+    {
+        for (std::size_t level = 1; level < levels_.size(); ++level) {
+            const auto& source = levels_[level - 1];
+            const glm::ivec2 source_size = level_sizes_[level - 1];
+            const glm::ivec2 level_size = level_sizes_[level];
+            auto& target = levels_[level];
+
+            for (int y = 0; y < level_size.y; ++y) {
+                const int y0 = 2 * y;
+                const int y1 = std::min(2 * y + 1, source_size.y - 1);
+                for (int x = 0; x < level_size.x; ++x) {
+                    const int x0 = 2 * x;
+                    const int x1 = std::min(2 * x + 1, source_size.x - 1);
+                    target[y * level_size.x + x] = std::max(
+                        std::max(source[y0 * source_size.x + x0], source[y0 * source_size.x + x1]),
+                        std::max(source[y1 * source_size.x + x0], source[y1 * source_size.x + x1]));
+                }
+            }
+        }
+    }
+}
+}
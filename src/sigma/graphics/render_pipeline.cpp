@@ -0,0 +1,81 @@
+#include <sigma/graphics/render_pipeline.hpp>
+
+namespace sigma {
+namespace graphics {
+    render_pipeline::render_pipeline(consume_function consume, frame_allocator* frames)
+        : consume_(std::move(consume))
+        , frames_(frames)
+        , states_ { slot_state::free, slot_state::free }
+    {
+        thread_ = std::thread { [this] { run_(); } };
+    }
+
+    render_pipeline::~render_pipeline()
+    {
+        {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            stopping_ = true;
+        }
+        changed_.notify_all();
+        thread_.join();
+    }
+
+    frame_packet& render_pipeline::begin_frame()
+    {
+        std::unique_lock<std::mutex> lock { mutex_ };
+        auto slot = submitted_ % 2;
+        changed_.wait(lock, [&] { return states_[slot] == slot_state::free; });
+        return packets_[slot];
+    }
+
+    void render_pipeline::submit()
+    {
+        {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            states_[submitted_ % 2] = slot_state::ready;
+            submitted_++;
+        }
+        changed_.notify_all();
+    }
+
+    void render_pipeline::flush()
+    {
+        std::unique_lock<std::mutex> lock { mutex_ };
+        changed_.wait(lock, [&] { return rendered_ == submitted_; });
+    }
+
+    std::uint64_t render_pipeline::submitted_frames() const
+    {
+        std::lock_guard<std::mutex> lock { mutex_ };
+        return submitted_;
+    }
+
+    std::uint64_t render_pipeline::rendered_frames() const
+    {
+        std::lock_guard<std::mutex> lock { mutex_ };
+        return rendered_;
+    }
+
+    void render_pipeline::run_()
+    {
+        std::unique_lock<std::mutex> lock { mutex_ };
+        while (true) {
+            auto slot = rendered_ % 2;
+            changed_.wait(lock, [&] { return states_[slot] == slot_state::ready || stopping_; });
+            if (states_[slot] != slot_state::ready)
+                return;
+
+            states_[slot] = slot_state::rendering;
+            lock.unlock();
+            if (frames_)
+                frames_->begin_frame();
+            consume_(packets_[slot]);
+            lock.lock();
+
+            states_[slot] = slot_state::free;
+            rendered_++;
+            changed_.notify_all();
+        }
+    }
+}
+}
@@ -1 +1,243 @@
-#include <sigma/graphics/render_queue.hpp>
\ No newline at end of file
+#include <sigma/graphics/render_queue.hpp>
+
+#include <sigma/util/parallel.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace sigma {
+namespace graphics {
+    namespace {
+        constexpr std::size_t RADIX_BITS = 8;
+        constexpr std::size_t RADIX_SIZE = 1 << RADIX_BITS;
+        constexpr std::size_t RADIX_GRAIN = 16384;
+        // Below this many entries a comparison sort is cheaper than the
+        // histogram passes.
+        constexpr std::size_t SMALL_SORT_SIZE = 256;
+
+        std::uint64_t quantize(float value, unsigned bits)
+        {
+            const float clamped = std::min(std::max(value, 0.0f), 1.0f);
+            const std::uint64_t max = (std::uint64_t(1) << bits) - 1;
+            return static_cast<std::uint64_t>(clamped * float(max) + 0.5f);
+        }
+
+        std::uint64_t field(std::uint64_t value, unsigned bits, unsigned shift)
+        {
+            return (value & ((std::uint64_t(1) << bits) - 1)) << shift;
+        }
+    }
+
+    std::uint64_t make_sort_key(std::uint8_t pass, std::uint32_t program, std::uint32_t material, std::uint32_t mesh, float depth)
+    {
+        return field(pass, 8, 56) | field(program, 12, 44) | field(material, 16, 28) | field(mesh, 16, 12) | quantize(depth, 12);
+    }
+
+    std::uint64_t make_blended_sort_key(std::uint8_t pass, float depth, std::uint32_t program, std::uint32_t material)
+    {
+        const std::uint64_t far_first = (std::uint64_t(1) << 24) - 1 - quantize(depth, 24);
+        return field(pass, 8, 56) | field(far_first, 24, 32) | field(program, 12, 20) | field(material, 16, 4);
+    }
+
+    render_command* command_bucket::enqueue(std::uint64_t key)
+    {
+        keys_.push_back(key);
+        commands_.emplace_back();
+        return &commands_.back();
+    }
+
+    std::size_t command_bucket::size() const noexcept
+    {
+        return keys_.size();
+    }
+
+    void command_bucket::clear()
+    {
+        commands_.clear();
+        keys_.clear();
+    }
+
+    render_command* render_queue::enqueue(std::uint64_t key)
+    {
+        entries_.push_back({ key, static_cast<std::uint32_t>(commands_.size()) });
+        commands_.emplace_back();
+        return &commands_.back();
+    }
+
+    std::size_t render_queue::size() const noexcept
+    {
+        return entries_.size();
+    }
+
+    bool render_queue::empty() const noexcept
+    {
+        return entries_.empty();
+    }
+
+    void render_queue::clear()
+    {
+        commands_.clear();
+        entries_.clear();
+        batches_.clear();
+        instances_.clear();
+        views_.clear();
+    }
+
+    std::uint32_t render_queue::add_view(const standard_block& block)
+    {
+        views_.push_back(block);
+        return static_cast<std::uint32_t>(views_.size() - 1);
+    }
+
+    const std::vector<standard_block>& render_queue::views() const noexcept
+    {
+        return views_;
+    }
+
+    void render_queue::reserve_buckets(std::size_t count)
+    {
+        if (buckets_.size() < count)
+            buckets_.resize(count);
+    }
+
+    std::size_t render_queue::bucket_count() const noexcept
+    {
+        return buckets_.size();
+    }
+
+    command_bucket& render_queue::bucket(std::size_t index)
+    {
+        return buckets_[index];
+    }
+
+    void render_queue::merge()
+    {
+        std::vector<std::size_t> offsets(buckets_.size() + 1, commands_.size());
+        for (std::size_t i = 0; i < buckets_.size(); ++i)
+            offsets[i + 1] = offsets[i] + buckets_[i].size();
+        if (offsets.back() == commands_.size())
+            return;
+
+        commands_.resize(offsets.back());
+        entries_.resize(offsets.back());
+        util::parallel_for(buckets_.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                auto& b = buckets_[i];
+                std::copy(b.commands_.begin(), b.commands_.end(), commands_.begin() + offsets[i]);
+                for (std::size_t j = 0; j < b.keys_.size(); ++j)
+                    entries_[offsets[i] + j] = { b.keys_[j], static_cast<std::uint32_t>(offsets[i] + j) };
+                b.clear();
+            }
+        });
+    }
+
+    void render_queue::sort()
+    {
+        radix_sort(entries_, scratch_);
+    }
+
+    const std::vector<render_queue::entry>& render_queue::entries() const noexcept
+    {
+        return entries_;
+    }
+
+    const std::vector<render_command>& render_queue::commands() const noexcept
+    {
+        return commands_;
+    }
+
+    const render_command& render_queue::command(const entry& e) const
+    {
+        return commands_[e.index];
+    }
+
+    void render_queue::build_batches()
+    {
+        batches_.clear();
+        instances_.resize(entries_.size());
+        for (std::uint32_t i = 0; i < entries_.size(); ++i) {
+            const auto& cmd = commands_[entries_[i].index];
+            instances_[i] = cmd.model;
+            if (!batches_.empty() && can_instance(commands_[entries_[batches_.back().first].index], cmd))
+                batches_.back().instance_count++;
+            else
+                batches_.push_back({ i, i, 1 });
+        }
+    }
+
+    const std::vector<render_queue::batch>& render_queue::batches() const noexcept
+    {
+        return batches_;
+    }
+
+    const std::vector<affine::matrix>& render_queue::instances() const noexcept
+    {
+        return instances_;
+    }
+
+    bool render_queue::can_instance(const render_command& a, const render_command& b) noexcept
+    {
+        return a.group == b.group
+            && a.view == b.view
+            && a.program == b.program
+            && a.mesh == b.mesh
+            && a.offset == b.offset
+            && a.count == b.count
+            && std::memcmp(a.buffer_bindings, b.buffer_bindings, sizeof(a.buffer_bindings)) == 0
+            && std::memcmp(a.input_textures, b.input_textures, sizeof(a.input_textures)) == 0;
+    }
+
+    void render_queue::radix_sort(std::vector<entry>& entries, std::vector<entry>& scratch)
+    {
+        const std::size_t count = entries.size();
+        if (count < SMALL_SORT_SIZE) {
+            std::stable_sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) { return a.key < b.key; });
+            return;
+        }
+
+        scratch.resize(count);
+        const std::size_t chunk_count = (count + RADIX_GRAIN - 1) / RADIX_GRAIN;
+        std::vector<std::array<std::size_t, RADIX_SIZE>> histograms(chunk_count);
+
+        entry* source = entries.data();
+        entry* target = scratch.data();
+        for (unsigned shift = 0; shift < 64; shift += RADIX_BITS) {
+            util::parallel_for(count, RADIX_GRAIN, [&](std::size_t begin, std::size_t end) {
+                auto& histogram = histograms[begin / RADIX_GRAIN];
+                histogram.fill(0);
+                for (std::size_t i = begin; i < end; ++i)
+                    histogram[(source[i].key >> shift) & (RADIX_SIZE - 1)]++;
+            });
+
+            // Turn the counts into the offset each chunk starts writing
+            // each digit at. Digits shared by every key are skipped, the
+            // high bits of most keys (pass, program) rarely differ.
+            std::size_t offset = 0;
+            bool single_digit = false;
+            for (std::size_t digit = 0; digit < RADIX_SIZE && !single_digit; ++digit) {
+                std::size_t digit_count = 0;
+                for (auto& histogram : histograms) {
+                    const std::size_t n = histogram[digit];
+                    histogram[digit] = offset;
+                    offset += n;
+                    digit_count += n;
+                }
+                single_digit = digit_count == count;
+            }
+            if (single_digit)
+                continue;
+
+            util::parallel_for(count, RADIX_GRAIN, [&](std::size_t begin, std::size_t end) {
+                auto& offsets = histograms[begin / RADIX_GRAIN];
+                for (std::size_t i = begin; i < end; ++i)
+                    target[offsets[(source[i].key >> shift) & (RADIX_SIZE - 1)]++] = source[i];
+            });
+            std::swap(source, target);
+        }
+
+        if (source != entries.data())
+            entries.swap(scratch);
+    }
+}
+}
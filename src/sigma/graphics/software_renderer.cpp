@@ -0,0 +1,269 @@
+#include <sigma/graphics/software_renderer.hpp>
+
+#include <sigma/graphics/rasterizer.hpp>
+#include <sigma/util/affine.hpp>
+#include <sigma/util/parallel.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sigma {
+namespace graphics {
+    namespace {
+        constexpr std::size_t SETUP_GRAIN = 64;
+
+        // Vertex before the perspective divide. The normal is interpolated
+        // linearly in clip space, like the position.
+        struct clip_vertex {
+            glm::vec4 position;
+            glm::vec3 normal;
+        };
+
+        // Clips a triangle against the near plane z = -w before the divide,
+        // where attributes still interpolate linearly. Returns the number of
+        // vertices of the polygon that is left: 0, 3 or 4.
+        int clip_near(const clip_vertex (&input)[3], clip_vertex (&output)[4])
+        {
+            int count = 0;
+            for (int i = 0; i < 3; ++i) {
+                const auto& from = input[i];
+                const auto& to = input[(i + 1) % 3];
+                const float from_distance = from.position.z + from.position.w;
+                const float to_distance = to.position.z + to.position.w;
+                if (from_distance >= 0)
+                    output[count++] = from;
+                if ((from_distance >= 0) != (to_distance >= 0)) {
+                    const float t = from_distance / (from_distance - to_distance);
+                    output[count++] = { glm::mix(from.position, to.position, t), glm::mix(from.normal, to.normal, t) };
+                }
+            }
+            return count;
+        }
+    }
+
+    std::size_t gbuffer::index(glm::ivec2 pixel) const noexcept
+    {
+        return std::size_t(pixel.y) * std::size_t(stride) + std::size_t(pixel.x);
+    }
+
+    software_renderer::software_renderer(glm::ivec2 size, std::shared_ptr<sigma::context> ctx)
+        : renderer(size, ctx)
+        , queue_(0)
+    {
+        resize(glm::uvec2 { size });
+    }
+
+    render_queue* software_renderer::queue()
+    {
+        return &queue_;
+    }
+
+    void software_renderer::resize(glm::uvec2 size)
+    {
+        gbuffer_.size = glm::ivec2 { size };
+        tile_count_ = (gbuffer_.size + TILE_SIZE - 1) / TILE_SIZE;
+        gbuffer_.stride = tile_count_.x * TILE_SIZE;
+
+        const std::size_t pixel_count = std::size_t(gbuffer_.stride) * std::size_t(tile_count_.y * TILE_SIZE);
+        gbuffer_.albedo.resize(pixel_count);
+        gbuffer_.roughness.resize(pixel_count);
+        gbuffer_.normal.resize(pixel_count);
+        gbuffer_.depth.resize(pixel_count);
+        bins_.resize(tile_count_.x * tile_count_.y);
+    }
+
+    void software_renderer::render()
+    {
+        clear_();
+        queue_.merge();
+        queue_.sort();
+
+        // Setup runs per chunk of sorted commands and binning walks the
+        // chunks in order, so tiles see triangles front to back whatever
+        // the number of threads.
+        const auto& entries = queue_.entries();
+        chunk_triangles_.resize((entries.size() + SETUP_GRAIN - 1) / SETUP_GRAIN);
+        util::parallel_for(entries.size(), SETUP_GRAIN, [&](std::size_t begin, std::size_t end) {
+            auto& output = chunk_triangles_[begin / SETUP_GRAIN];
+            output.clear();
+            for (std::size_t i = begin; i < end; ++i)
+                setup_(queue_.command(entries[i]), output);
+        });
+
+        for (auto& bin : bins_)
+            bin.clear();
+        for (const auto& chunk : chunk_triangles_) {
+            for (const auto& tri : chunk)
+                bin_(tri);
+        }
+
+        util::parallel_for(bins_.size(), 1, [this](std::size_t begin, std::size_t end) {
+            for (std::size_t tile = begin; tile < end; ++tile)
+                rasterize_tile_(static_cast<int>(tile));
+        });
+
+        queue_.clear();
+    }
+
+    void software_renderer::set_mesh(std::uint64_t id, resource::handle_type<static_mesh> mesh)
+    {
+        meshes_[id] = mesh;
+    }
+
+    void software_renderer::set_surface(std::uint64_t texture, const surface& s)
+    {
+        surfaces_[texture] = s;
+    }
+
+    const gbuffer& software_renderer::output() const noexcept
+    {
+        return gbuffer_;
+    }
+
+    void software_renderer::clear_()
+    {
+        std::fill(gbuffer_.albedo.begin(), gbuffer_.albedo.end(), glm::vec3 { 0.0f });
+        std::fill(gbuffer_.roughness.begin(), gbuffer_.roughness.end(), 0.0f);
+        std::fill(gbuffer_.normal.begin(), gbuffer_.normal.end(), glm::vec3 { 0.0f });
+        std::fill(gbuffer_.depth.begin(), gbuffer_.depth.end(), 1.0f);
+    }
+
+    void software_renderer::setup_(const render_command& cmd, std::vector<screen_triangle>& output) const
+    {
+        auto mesh_it = meshes_.find(cmd.mesh);
+        if (mesh_it == meshes_.end() || !mesh_it->second || cmd.view >= queue_.views().size())
+            return;
+        const auto& mesh = *mesh_it->second;
+        const auto& vertices = mesh.vertices();
+        const auto& triangles = mesh.triangles();
+
+        auto surface_it = surfaces_.find(cmd.input_textures[0]);
+        const surface* material = surface_it != surfaces_.end() ? &surface_it->second : &default_surface_;
+
+        const glm::mat4 mvp = affine::multiply(queue_.views()[cmd.view].projection_view_matrix, cmd.model);
+
+        // Normals go through the cofactor matrix, the inverse transpose up
+        // to a scale that is normalized away per pixel.
+        const glm::vec3 c0 { cmd.model[0][0], cmd.model[1][0], cmd.model[2][0] };
+        const glm::vec3 c1 { cmd.model[0][1], cmd.model[1][1], cmd.model[2][1] };
+        const glm::vec3 c2 { cmd.model[0][2], cmd.model[1][2], cmd.model[2][2] };
+        glm::vec3 cofactor[3] = { glm::cross(c1, c2), glm::cross(c2, c0), glm::cross(c0, c1) };
+        if (glm::dot(c0, cofactor[0]) < 0) {
+            for (auto& c : cofactor)
+                c = -c;
+        }
+
+        std::size_t first = cmd.offset / 3;
+        std::size_t last = cmd.count == 0 ? triangles.size() : std::min(triangles.size(), (cmd.offset + cmd.count) / 3);
+
+        const glm::vec2 half_size = glm::vec2 { gbuffer_.size } * 0.5f;
+        auto add_triangle = [&](const clip_vertex& c0, const clip_vertex& c1, const clip_vertex& c2) {
+            screen_triangle tri;
+            tri.material = material;
+            const clip_vertex* corners[3] = { &c0, &c1, &c2 };
+            for (int k = 0; k < 3; ++k) {
+                const glm::vec4& clip = corners[k]->position;
+                if (clip.w <= rasterizer::MIN_W)
+                    return;
+
+                const float inverse_w = 1.0f / clip.w;
+                const glm::vec3 ndc = glm::vec3 { clip } * inverse_w;
+                tri.v[k] = { (ndc.x + 1.0f) * half_size.x, (ndc.y + 1.0f) * half_size.y, ndc.z * 0.5f + 0.5f };
+                tri.inverse_w[k] = inverse_w;
+                tri.normal[k] = corners[k]->normal * inverse_w;
+            }
+            if (tri.v[0].z > 1 && tri.v[1].z > 1 && tri.v[2].z > 1)
+                return;
+
+            if (!rasterizer::is_front_facing(tri.v[0], tri.v[1], tri.v[2]))
+                return;
+
+            output.push_back(tri);
+        };
+
+        for (std::size_t t = first; t < last; ++t) {
+            clip_vertex corners[3];
+            for (int k = 0; k < 3; ++k) {
+                const auto& v = vertices[triangles[t][k]];
+                corners[k] = { mvp * glm::vec4 { v.position, 1.0f }, cofactor[0] * v.normal.x + cofactor[1] * v.normal.y + cofactor[2] * v.normal.z };
+            }
+
+            // Triangles crossing the near plane become a quad, drawn as a fan.
+            clip_vertex polygon[4];
+            const int count = clip_near(corners, polygon);
+            for (int i = 1; i + 1 < count; ++i)
+                add_triangle(polygon[0], polygon[i], polygon[i + 1]);
+        }
+    }
+
+    void software_renderer::bin_(const screen_triangle& tri)
+    {
+        glm::ivec2 first_tile, last_tile;
+        if (!rasterizer::tile_range(tri.v[0], tri.v[1], tri.v[2], gbuffer_.size, TILE_SIZE, tile_count_, first_tile, last_tile))
+            return;
+        for (int y = first_tile.y; y <= last_tile.y; ++y) {
+            for (int x = first_tile.x; x <= last_tile.x; ++x)
+                bins_[y * tile_count_.x + x].push_back(&tri);
+        }
+    }
+
+    void software_renderer::rasterize_tile_(int tile)
+    {
+        const glm::ivec2 origin = glm::ivec2 { tile % tile_count_.x, tile / tile_count_.x } * TILE_SIZE;
+        const glm::ivec2 limit = glm::min(origin + TILE_SIZE, gbuffer_.size);
+
+        for (const auto* tri : bins_[tile]) {
+            const rasterizer::edge e0 { tri->v[1], tri->v[2] };
+            const rasterizer::edge e1 { tri->v[2], tri->v[0] };
+            const rasterizer::edge e2 { tri->v[0], tri->v[1] };
+            const float inverse_area = 1.0f / e2(tri->v[2].x, tri->v[2].y);
+
+            glm::vec2 min, max;
+            rasterizer::screen_bounds(tri->v[0], tri->v[1], tri->v[2], min, max);
+            const int x_begin = std::max(origin.x, static_cast<int>(std::floor(min.x))) & ~(rasterizer::LANE_COUNT - 1);
+            const int x_end = std::min(limit.x, static_cast<int>(std::ceil(max.x)));
+            const int y_begin = std::max(origin.y, static_cast<int>(std::floor(min.y)));
+            const int y_end = std::min(limit.y, static_cast<int>(std::ceil(max.y)));
+
+            for (int y = y_begin; y < y_end; ++y) {
+                const float py = y + 0.5f;
+                const std::size_t row = std::size_t(y) * std::size_t(gbuffer_.stride);
+                for (int x = x_begin; x < x_end; x += rasterizer::LANE_COUNT) {
+                    // Rows are padded to whole tiles so every lane of the
+                    // depth row can be loaded. The mask is built with & so
+                    // the load is not behind a branch, and is kept as int
+                    // lanes as wide as the floats so the loop vectorizes.
+                    const float* depth = gbuffer_.depth.data() + row + x;
+                    float b0[rasterizer::LANE_COUNT], b1[rasterizer::LANE_COUNT], b2[rasterizer::LANE_COUNT], z[rasterizer::LANE_COUNT];
+                    int pass[rasterizer::LANE_COUNT];
+                    for (int lane = 0; lane < rasterizer::LANE_COUNT; ++lane) {
+                        const float px = x + lane + 0.5f;
+                        const float w0 = e0(px, py);
+                        const float w1 = e1(px, py);
+                        const float w2 = e2(px, py);
+                        b0[lane] = w0 * inverse_area;
+                        b1[lane] = w1 * inverse_area;
+                        b2[lane] = w2 * inverse_area;
+                        z[lane] = b0[lane] * tri->v[0].z + b1[lane] * tri->v[1].z + b2[lane] * tri->v[2].z;
+                        pass[lane] = e0.covers(w0) & e1.covers(w1) & e2.covers(w2) & (z[lane] >= 0) & (z[lane] < depth[lane]);
+                    }
+
+                    for (int lane = 0; lane < rasterizer::LANE_COUNT; ++lane) {
+                        if (!pass[lane])
+                            continue;
+                        const std::size_t i = row + x + lane;
+                        const float w = 1.0f / (b0[lane] * tri->inverse_w[0] + b1[lane] * tri->inverse_w[1] + b2[lane] * tri->inverse_w[2]);
+                        const glm::vec3 n = (tri->normal[0] * b0[lane] + tri->normal[1] * b1[lane] + tri->normal[2] * b2[lane]) * w;
+                        gbuffer_.depth[i] = z[lane];
+                        gbuffer_.albedo[i] = tri->material->albedo;
+                        gbuffer_.roughness[i] = tri->material->roughness;
+                        gbuffer_.normal[i] = glm::length(n) > 0 ? glm::normalize(n) : n;
+                    }
+                }
+            }
+        }
+    }
+}
+}
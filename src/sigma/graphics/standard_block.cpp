@@ -0,0 +1,59 @@
+#include <sigma/graphics/standard_block.hpp>
+
+#include <sigma/util/numeric.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace sigma {
+namespace graphics {
+    namespace {
+        template <class T>
+        void write(std::byte* block, std::size_t offset, const T& value)
+        {
+            std::memcpy(block + offset, &value, sizeof(T));
+        }
+    }
+
+    standard_block make_standard_block(const frustum& view, glm::ivec2 size, float time)
+    {
+        standard_block block;
+        block.projection_matrix = view.projection();
+        block.inverse_projection_matrix = view.inverse_projection();
+        block.view_matrix = view.view();
+        block.inverse_view_matrix = view.inverse_view();
+        block.projection_view_matrix = view.projection_view();
+        block.inverse_projection_view_matrix = view.inverse_projection_view();
+        block.view_port_size = glm::vec2 { size };
+        block.eye_position = block.inverse_view_matrix[3];
+        block.time = time;
+        block.fovy = view.fovy();
+        block.z_near = view.z_near();
+        block.z_far = view.z_far();
+        return block;
+    }
+
+    std::size_t pack_std140(const standard_block* blocks, std::size_t count, std::size_t alignment, std::vector<std::byte>& output)
+    {
+        const std::size_t stride = numeric::round_up(standard_block::STD140_SIZE, std::max<std::size_t>(alignment, 16));
+        output.assign(count * stride, std::byte { 0 });
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& b = blocks[i];
+            std::byte* out = output.data() + i * stride;
+            write(out, 0, b.projection_matrix);
+            write(out, 64, b.inverse_projection_matrix);
+            write(out, 128, b.view_matrix);
+            write(out, 192, b.inverse_view_matrix);
+            write(out, 256, b.projection_view_matrix);
+            write(out, 320, b.inverse_projection_view_matrix);
+            write(out, 384, b.view_port_size);
+            write(out, 400, b.eye_position);
+            write(out, 416, b.time);
+            write(out, 420, b.fovy);
+            write(out, 424, b.z_near);
+            write(out, 428, b.z_far);
+        }
+        return stride;
+    }
+}
+}
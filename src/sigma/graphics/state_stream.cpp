@@ -0,0 +1,54 @@
+#include <sigma/graphics/state_stream.hpp>
+
+namespace sigma {
+namespace graphics {
+    void state_stream::build(const render_queue& queue)
+    {
+        clear();
+
+        const auto& batches = queue.batches();
+        const render_command* previous = nullptr;
+        auto bind = [&](state_op op, std::uint8_t slot, std::uint64_t value, std::uint64_t previous_value) {
+            if (previous && value == previous_value) {
+                stats_.eliminated_binds++;
+                return;
+            }
+            changes_.push_back({ op, slot, value });
+            stats_.binds++;
+        };
+
+        for (std::size_t i = 0; i < batches.size(); ++i) {
+            const auto& cmd = queue.command(queue.entries()[batches[i].first]);
+
+            bind(state_op::bind_view, 0, cmd.view, previous ? previous->view : 0);
+            bind(state_op::bind_group, 0, cmd.group, previous ? previous->group : 0);
+            bind(state_op::bind_program, 0, cmd.program, previous ? previous->program : 0);
+            for (std::uint8_t slot = 0; slot < MAX_BUFFER_BINDINGS; ++slot)
+                bind(state_op::bind_buffer, slot, cmd.buffer_bindings[slot], previous ? previous->buffer_bindings[slot] : 0);
+            for (std::uint8_t slot = 0; slot < MAX_TEXTURE_BINDINGS; ++slot)
+                bind(state_op::bind_texture, slot, cmd.input_textures[slot], previous ? previous->input_textures[slot] : 0);
+            bind(state_op::bind_mesh, 0, cmd.mesh, previous ? previous->mesh : 0);
+
+            changes_.push_back({ state_op::draw, 0, i });
+            stats_.draws++;
+            previous = &cmd;
+        }
+    }
+
+    void state_stream::clear()
+    {
+        changes_.clear();
+        stats_ = {};
+    }
+
+    const std::vector<state_change>& state_stream::changes() const noexcept
+    {
+        return changes_;
+    }
+
+    const state_stream::statistics& state_stream::stats() const noexcept
+    {
+        return stats_;
+    }
+}
+}
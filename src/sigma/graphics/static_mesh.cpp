@@ -1,7 +1,116 @@
 #include <sigma/graphics/static_mesh.hpp>
 
+#include <sigma/util/parallel.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <limits>
+
 namespace sigma {
 namespace graphics {
+    namespace {
+        constexpr std::size_t LANE_COUNT = 8;
+        constexpr std::size_t REDUCTION_GRAIN = 16384;
+
+        struct point_bounds {
+            glm::vec3 min { std::numeric_limits<float>::max() };
+            glm::vec3 max { std::numeric_limits<float>::lowest() };
+        };
+
+        // Min and max of count points, reduced over chunks in parallel with lane wide accumulators
+        // in each chunk.
+        template <class Position>
+        point_bounds reduce_bounds(std::size_t count, Position&& position)
+        {
+            std::vector<point_bounds> partials((count + REDUCTION_GRAIN - 1) / REDUCTION_GRAIN);
+            util::parallel_for(count, REDUCTION_GRAIN, [&](std::size_t begin, std::size_t end) {
+                float lo[3][LANE_COUNT];
+                float hi[3][LANE_COUNT];
+                for (std::size_t lane = 0; lane < LANE_COUNT; ++lane) {
+                    for (int a = 0; a < 3; ++a) {
+                        lo[a][lane] = std::numeric_limits<float>::max();
+                        hi[a][lane] = std::numeric_limits<float>::lowest();
+                    }
+                }
+
+                for (std::size_t i = begin; i < end; i += LANE_COUNT) {
+                    const std::size_t lanes = std::min(LANE_COUNT, end - i);
+                    for (std::size_t lane = 0; lane < lanes; ++lane) {
+                        const glm::vec3& p = position(i + lane);
+                        for (int a = 0; a < 3; ++a) {
+                            lo[a][lane] = std::min(lo[a][lane], p[a]);
+                            hi[a][lane] = std::max(hi[a][lane], p[a]);
+                        }
+                    }
+                }
+
+                auto& result = partials[begin / REDUCTION_GRAIN];
+                for (std::size_t lane = 0; lane < LANE_COUNT; ++lane) {
+                    for (int a = 0; a < 3; ++a) {
+                        result.min[a] = std::min(result.min[a], lo[a][lane]);
+                        result.max[a] = std::max(result.max[a], hi[a][lane]);
+                    }
+                }
+            });
+
+            point_bounds result;
+            for (const auto& partial : partials) {
+                result.min = glm::min(result.min, partial.min);
+                result.max = glm::max(result.max, partial.max);
+            }
+            return result;
+        }
+
+        template <class Position>
+        std::size_t farthest_point(std::size_t count, Position&& position, const glm::vec3& from)
+        {
+            std::size_t farthest = 0;
+            float farthest_distance2 = -1.0f;
+            for (std::size_t i = 0; i < count; ++i) {
+                glm::vec3 d = position(i) - from;
+                float distance2 = glm::dot(d, d);
+                if (distance2 > farthest_distance2) {
+                    farthest = i;
+                    farthest_distance2 = distance2;
+                }
+            }
+            return farthest;
+        }
+
+        // Ritter's bounding sphere, within a few percent of the minimal one.
+        template <class Position>
+        bounding_sphere ritter_sphere(std::size_t count, Position&& position)
+        {
+            bounding_sphere sphere;
+            if (count == 0)
+                return sphere;
+
+            const glm::vec3 y = position(farthest_point(count, position, position(0)));
+            const glm::vec3 z = position(farthest_point(count, position, y));
+            sphere.center = (y + z) * 0.5f;
+            sphere.radius = glm::distance(y, z) * 0.5f;
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const glm::vec3 p = position(i);
+                const float distance = glm::distance(p, sphere.center);
+                if (distance > sphere.radius) {
+                    const float radius = (sphere.radius + distance) * 0.5f;
+                    sphere.center += (p - sphere.center) * ((radius - sphere.radius) / distance);
+                    sphere.radius = radius;
+                }
+            }
+            return sphere;
+        }
+
+        AABB make_aabb(const point_bounds& bounds)
+        {
+            if (bounds.min.x > bounds.max.x)
+                return { glm::vec3 { 0.0f }, glm::vec3 { 0.0f } };
+            return { (bounds.min + bounds.max) * 0.5f, bounds.max - bounds.min };
+        }
+    }
+
     mesh_part::mesh_part()
         : start_(0)
         , end_(0)
@@ -31,6 +140,22 @@ namespace graphics {
         return material_;
     }
 
+    const AABB& mesh_part::bounds() const
+    {
+        return bounds_;
+    }
+
+    const bounding_sphere& mesh_part::sphere() const
+    {
+        return sphere_;
+    }
+
+    void mesh_part::set_bounds(const AABB& bounds, const bounding_sphere& sphere)
+    {
+        bounds_ = bounds;
+        sphere_ = sphere;
+    }
+
     static_mesh::static_mesh(std::weak_ptr<sigma::context> ctx, resource::key_type key)
         : resource::base_resource::base_resource(std::move(ctx), std::move(key))
     {
@@ -75,5 +200,37 @@ namespace graphics {
     {
         radius_ = r;
     }
+
+    const AABB& static_mesh::bounds() const
+    {
+        return bounds_;
+    }
+
+    const bounding_sphere& static_mesh::sphere() const
+    {
+        return sphere_;
+    }
+
+    void static_mesh::compute_bounds()
+    {
+        auto vertex_position = [this](std::size_t i) -> const glm::vec3& {
+            return vertices_[i].position;
+        };
+
+        bounds_ = make_aabb(reduce_bounds(vertices_.size(), vertex_position));
+        sphere_ = ritter_sphere(vertices_.size(), vertex_position);
+
+        // Parts only cover the vertices their triangles reference, large
+        // meshes usually have few parts so they are handled one at a time
+        // and each is reduced in parallel.
+        for (auto& part : parts_) {
+            const std::size_t first = std::min(part.start(), triangles_.size());
+            const std::size_t count = 3 * (std::max(first, std::min(part.end(), triangles_.size())) - first);
+            auto part_position = [this, first](std::size_t i) -> const glm::vec3& {
+                return vertices_[triangles_[first + i / 3][i % 3]].position;
+            };
+            part.set_bounds(make_aabb(reduce_bounds(count, part_position)), ritter_sphere(count, part_position));
+        }
+    }
 }
 }
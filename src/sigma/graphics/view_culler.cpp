@@ -0,0 +1,151 @@
+#include <sigma/graphics/view_culler.hpp>
+
+#include <glm/gtc/matrix_access.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace sigma {
+namespace graphics {
+    std::size_t view_culler::view_count() const noexcept
+    {
+        return view_count_;
+    }
+
+    std::size_t view_culler::add_view(const frustum& view)
+    {
+        return add_planes_(view.planes());
+    }
+
+    std::size_t view_culler::add_view(const glm::mat4& projection_view)
+    {
+        // http://gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
+        std::array<glm::vec4, 6> planes;
+        planes[0] = glm::row(projection_view, 3) + glm::row(projection_view, 0);
+        planes[1] = glm::row(projection_view, 3) - glm::row(projection_view, 0);
+        planes[2] = glm::row(projection_view, 3) + glm::row(projection_view, 1);
+        planes[3] = glm::row(projection_view, 3) - glm::row(projection_view, 1);
+        planes[4] = glm::row(projection_view, 3) + glm::row(projection_view, 2);
+        planes[5] = glm::row(projection_view, 3) - glm::row(projection_view, 2);
+        return add_planes_(planes);
+    }
+
+    void view_culler::clear() noexcept
+    {
+        view_count_ = 0;
+    }
+
+    bool view_culler::test(const glm::vec3& min, const glm::vec3& max, std::uint64_t& mask) const noexcept
+    {
+        const glm::vec3 center = (min + max) * 0.5f;
+        const glm::vec3 extent = (max - min) * 0.5f;
+
+        std::uint64_t outside = 0;
+        for (std::size_t p = 0; p < 6; ++p) {
+            const auto& x = x_[p];
+            const auto& y = y_[p];
+            const auto& z = z_[p];
+            const auto& w = w_[p];
+            for (std::size_t v = 0; v < view_count_; ++v) {
+                float distance = x[v] * center.x + y[v] * center.y + z[v] * center.z + w[v];
+                float radius = std::abs(x[v]) * extent.x + std::abs(y[v]) * extent.y + std::abs(z[v]) * extent.z;
+                outside |= std::uint64_t(distance + radius < 0) << v;
+            }
+        }
+
+        mask &= ~outside;
+        return mask != 0;
+    }
+
+    void view_culler::cull(const bvh& scene, std::vector<std::uint64_t>& masks) const
+    {
+        cull_(scene, masks);
+    }
+
+    void view_culler::build_draw_list(const std::vector<std::uint64_t>& masks, std::size_t view, std::vector<std::uint32_t>& draw_list) const
+    {
+        build_draw_list_(masks, view, draw_list);
+    }
+
+    void view_culler::build_draw_lists(const std::vector<std::uint64_t>& masks, std::vector<std::vector<std::uint32_t>>& draw_lists) const
+    {
+        draw_lists.resize(view_count_);
+        for (auto& list : draw_lists)
+            list.clear();
+        build_draw_lists_(masks, draw_lists);
+    }
+
+    void view_culler::cull(const bvh& scene, frame_vector<std::uint64_t>& masks) const
+    {
+        cull_(scene, masks);
+    }
+
+    void view_culler::build_draw_list(const frame_vector<std::uint64_t>& masks, std::size_t view, frame_vector<std::uint32_t>& draw_list) const
+    {
+        build_draw_list_(masks, view, draw_list);
+    }
+
+    void view_culler::build_draw_lists(const frame_vector<std::uint64_t>& masks, std::vector<frame_vector<std::uint32_t>>& draw_lists) const
+    {
+        // Lists kept from an earlier frame may point into a reset arena.
+        draw_lists.assign(view_count_, frame_vector<std::uint32_t> { masks.get_allocator() });
+        build_draw_lists_(masks, draw_lists);
+    }
+
+    std::size_t view_culler::add_planes_(const std::array<glm::vec4, 6>& planes)
+    {
+        if (view_count_ >= MAX_VIEWS)
+            throw std::length_error("view_culler supports at most 64 views");
+
+        std::size_t view = view_count_++;
+        for (std::size_t p = 0; p < 6; ++p) {
+            x_[p][view] = planes[p].x;
+            y_[p][view] = planes[p].y;
+            z_[p][view] = planes[p].z;
+            w_[p][view] = planes[p].w;
+        }
+        return view;
+    }
+
+    template <class Masks>
+    void view_culler::cull_(const bvh& scene, Masks& masks) const
+    {
+        masks.assign(scene.size(), 0);
+        if (view_count_ == 0)
+            return;
+
+        std::uint64_t all_views = view_count_ == MAX_VIEWS ? ~std::uint64_t(0) : (std::uint64_t(1) << view_count_) - 1;
+        scene.traverse(all_views,
+            [this](const bvh::node& n, std::uint64_t& mask) {
+                return test(n.min, n.max, mask);
+            },
+            [this, &scene, &masks](std::uint32_t primitive, std::uint64_t mask) {
+                test(scene.min(primitive), scene.max(primitive), mask);
+                masks[primitive] = mask;
+            });
+    }
+
+    template <class Masks, class List>
+    void view_culler::build_draw_list_(const Masks& masks, std::size_t view, List& draw_list) const
+    {
+        draw_list.clear();
+        const std::uint64_t bit = std::uint64_t(1) << view;
+        for (std::uint32_t i = 0; i < masks.size(); ++i) {
+            if (masks[i] & bit)
+                draw_list.push_back(i);
+        }
+    }
+
+    template <class Masks, class List>
+    void view_culler::build_draw_lists_(const Masks& masks, std::vector<List>& draw_lists) const
+    {
+        for (std::uint32_t i = 0; i < masks.size(); ++i) {
+            auto mask = masks[i];
+            for (std::size_t view = 0; mask != 0; ++view, mask >>= 1) {
+                if (mask & 1)
+                    draw_lists[view].push_back(i);
+            }
+        }
+    }
+}
+}
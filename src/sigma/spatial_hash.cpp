@@ -0,0 +1,205 @@
+#include <sigma/spatial_hash.hpp>
+
+#include <cassert>
+#include <cmath>
+
+namespace sigma {
+spatial_hash::spatial_hash(float cell_size)
+    : cell_size_(cell_size)
+    , inverse_cell_size_(1.0f / cell_size)
+{
+}
+
+float spatial_hash::cell_size() const noexcept
+{
+    return cell_size_;
+}
+
+std::size_t spatial_hash::size() const noexcept
+{
+    return size_;
+}
+
+std::size_t spatial_hash::cell_count() const noexcept
+{
+    return cells_.size() - free_cells_.size();
+}
+
+glm::vec3 spatial_hash::loose() const noexcept
+{
+    return loose_;
+}
+
+bool spatial_hash::contains(std::uint32_t id) const noexcept
+{
+    return id < entries_.size() && entries_[id].cell != INVALID_CELL;
+}
+
+void spatial_hash::insert(std::uint32_t id, const AABB& bounds)
+{
+    insert(id, bounds.min(), bounds.max());
+}
+
+void spatial_hash::insert(std::uint32_t id, const glm::vec3& min, const glm::vec3& max)
+{
+    if (contains(id)) {
+        update(id, min, max);
+        return;
+    }
+
+    if (id >= entries_.size())
+        entries_.resize(id + 1);
+
+    auto& e = entries_[id];
+    e.min = min;
+    e.max = max;
+    grow_loose_((max - min) * 0.5f);
+    link_(id, find_or_create_cell_(coordinate_((min + max) * 0.5f)));
+    size_++;
+}
+
+void spatial_hash::update(std::uint32_t id, const AABB& bounds)
+{
+    update(id, bounds.min(), bounds.max());
+}
+
+void spatial_hash::update(std::uint32_t id, const glm::vec3& min, const glm::vec3& max)
+{
+    assert(contains(id));
+
+    auto& e = entries_[id];
+    const glm::vec3 old_half_size = (e.max - e.min) * 0.5f;
+    e.min = min;
+    e.max = max;
+    grow_loose_((max - min) * 0.5f);
+    shrink_loose_(old_half_size);
+
+    auto coordinate = coordinate_((min + max) * 0.5f);
+    if (cells_[e.cell].coordinate == coordinate)
+        return;
+
+    unlink_(id);
+    link_(id, find_or_create_cell_(coordinate));
+}
+
+void spatial_hash::remove(std::uint32_t id)
+{
+    if (!contains(id))
+        return;
+
+    unlink_(id);
+    auto& e = entries_[id];
+    e.cell = INVALID_CELL;
+    size_--;
+    shrink_loose_((e.max - e.min) * 0.5f);
+}
+
+void spatial_hash::clear()
+{
+    loose_ = glm::vec3 { 0.0f };
+    loose_count_ = {};
+    size_ = 0;
+    occupied_cells_ = 0;
+    entries_.clear();
+    cells_.clear();
+    free_cells_.clear();
+    cell_lookup_.clear();
+}
+
+glm::ivec3 spatial_hash::coordinate_(const glm::vec3& p) const noexcept
+{
+    return glm::ivec3 { glm::floor(p * inverse_cell_size_) };
+}
+
+std::uint64_t spatial_hash::key_(const glm::ivec3& coordinate) noexcept
+{
+    // 21 bits per axis, offset so negative coordinates pack correctly.
+    constexpr std::uint64_t mask = (std::uint64_t(1) << 21) - 1;
+    constexpr std::int64_t offset = std::int64_t(1) << 20;
+    return ((static_cast<std::uint64_t>(coordinate.x + offset) & mask) << 42)
+        | ((static_cast<std::uint64_t>(coordinate.y + offset) & mask) << 21)
+        | (static_cast<std::uint64_t>(coordinate.z + offset) & mask);
+}
+
+std::uint32_t spatial_hash::find_or_create_cell_(const glm::ivec3& coordinate)
+{
+    auto key = key_(coordinate);
+    auto it = cell_lookup_.find(key);
+    if (it != cell_lookup_.end())
+        return it->second;
+
+    std::uint32_t index;
+    if (!free_cells_.empty()) {
+        index = free_cells_.back();
+        free_cells_.pop_back();
+        cells_[index].coordinate = coordinate;
+    } else {
+        index = static_cast<std::uint32_t>(cells_.size());
+        cells_.push_back(cell { coordinate, {} });
+    }
+    cell_lookup_.emplace(key, index);
+    return index;
+}
+
+void spatial_hash::link_(std::uint32_t id, std::uint32_t cell_index)
+{
+    auto& c = cells_[cell_index];
+    if (c.ids.empty())
+        occupied_cells_++;
+
+    auto& e = entries_[id];
+    e.cell = cell_index;
+    e.slot = static_cast<std::uint32_t>(c.ids.size());
+    c.ids.push_back(id);
+}
+
+void spatial_hash::unlink_(std::uint32_t id)
+{
+    const auto& e = entries_[id];
+    auto& c = cells_[e.cell];
+
+    auto last = c.ids.back();
+    c.ids[e.slot] = last;
+    entries_[last].slot = e.slot;
+    c.ids.pop_back();
+
+    // Empty cells go back to the free list, their id storage is kept.
+    if (c.ids.empty()) {
+        occupied_cells_--;
+        cell_lookup_.erase(key_(c.coordinate));
+        free_cells_.push_back(e.cell);
+    }
+}
+
+void spatial_hash::grow_loose_(const glm::vec3& half_size) noexcept
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        if (half_size[axis] > loose_[axis]) {
+            loose_[axis] = half_size[axis];
+            loose_count_[axis] = 1;
+        } else if (half_size[axis] == loose_[axis]) {
+            loose_count_[axis]++;
+        }
+    }
+}
+
+void spatial_hash::shrink_loose_(const glm::vec3& half_size)
+{
+    bool recompute = false;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (half_size[axis] == loose_[axis] && --loose_count_[axis] == 0)
+            recompute = true;
+    }
+    if (!recompute)
+        return;
+
+    // The last object of the largest size left, only then is every
+    // contained object visited.
+    loose_ = glm::vec3 { 0.0f };
+    loose_count_ = {};
+    for (const auto& e : entries_) {
+        if (e.cell != INVALID_CELL)
+            grow_loose_((e.max - e.min) * 0.5f);
+    }
+}
+}
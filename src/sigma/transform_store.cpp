@@ -0,0 +1,210 @@
+#include <sigma/transform_store.hpp>
+
+#include <sigma/util/parallel.hpp>
+
+#include <algorithm>
+
+namespace sigma {
+namespace {
+    constexpr std::size_t LANE_COUNT = 8;
+    constexpr std::size_t GRAIN_SIZE = 8192;
+}
+
+std::size_t transform_store::size() const noexcept
+{
+    return entities_.size();
+}
+
+bool transform_store::contains(entity_type entity) const noexcept
+{
+    return slots_.count(entity) != 0;
+}
+
+void transform_store::insert(entity_type entity, const transform& t)
+{
+    if (contains(entity)) {
+        set_position(entity, t.position);
+        set_rotation(entity, t.rotation);
+        set_scale(entity, t.scale);
+        return;
+    }
+
+    slots_[entity] = static_cast<std::uint32_t>(entities_.size());
+    entities_.push_back(entity);
+    for (int i = 0; i < 3; ++i) {
+        position_[i].push_back(t.position[i]);
+        scale_[i].push_back(t.scale[i]);
+    }
+    rotation_[0].push_back(t.rotation.x);
+    rotation_[1].push_back(t.rotation.y);
+    rotation_[2].push_back(t.rotation.z);
+    rotation_[3].push_back(t.rotation.w);
+    matrices_.push_back(affine::identity());
+}
+
+void transform_store::remove(entity_type entity)
+{
+    auto it = slots_.find(entity);
+    if (it == slots_.end())
+        return;
+
+    const std::uint32_t slot = it->second;
+    const std::size_t last = entities_.size() - 1;
+    auto move_last = [&](std::vector<float>& v) {
+        v[slot] = v[last];
+        v.pop_back();
+    };
+    for (int i = 0; i < 3; ++i) {
+        move_last(position_[i]);
+        move_last(scale_[i]);
+    }
+    for (int i = 0; i < 4; ++i)
+        move_last(rotation_[i]);
+    matrices_[slot] = matrices_[last];
+    matrices_.pop_back();
+
+    entities_[slot] = entities_[last];
+    entities_.pop_back();
+    slots_.erase(it);
+    if (slot != last)
+        slots_[entities_[slot]] = slot;
+}
+
+void transform_store::clear()
+{
+    for (int i = 0; i < 3; ++i) {
+        position_[i].clear();
+        scale_[i].clear();
+    }
+    for (int i = 0; i < 4; ++i)
+        rotation_[i].clear();
+    matrices_.clear();
+    entities_.clear();
+    slots_.clear();
+}
+
+glm::vec3 transform_store::position(entity_type entity) const
+{
+    const auto slot = slot_(entity);
+    return { position_[0][slot], position_[1][slot], position_[2][slot] };
+}
+
+void transform_store::set_position(entity_type entity, const glm::vec3& position)
+{
+    const auto slot = slot_(entity);
+    for (int i = 0; i < 3; ++i)
+        position_[i][slot] = position[i];
+}
+
+glm::quat transform_store::rotation(entity_type entity) const
+{
+    const auto slot = slot_(entity);
+    return { rotation_[3][slot], rotation_[0][slot], rotation_[1][slot], rotation_[2][slot] };
+}
+
+void transform_store::set_rotation(entity_type entity, const glm::quat& rotation)
+{
+    const auto slot = slot_(entity);
+    rotation_[0][slot] = rotation.x;
+    rotation_[1][slot] = rotation.y;
+    rotation_[2][slot] = rotation.z;
+    rotation_[3][slot] = rotation.w;
+}
+
+glm::vec3 transform_store::scale(entity_type entity) const
+{
+    const auto slot = slot_(entity);
+    return { scale_[0][slot], scale_[1][slot], scale_[2][slot] };
+}
+
+void transform_store::set_scale(entity_type entity, const glm::vec3& scale)
+{
+    const auto slot = slot_(entity);
+    for (int i = 0; i < 3; ++i)
+        scale_[i][slot] = scale[i];
+}
+
+void transform_store::compose()
+{
+    const arrays input = data();
+    util::parallel_for(entities_.size(), GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+        arrays chunk;
+        for (int i = 0; i < 3; ++i) {
+            chunk.position[i] = input.position[i] + begin;
+            chunk.scale[i] = input.scale[i] + begin;
+        }
+        for (int i = 0; i < 4; ++i)
+            chunk.rotation[i] = input.rotation[i] + begin;
+        compose(chunk, end - begin, matrices_.data() + begin);
+    });
+}
+
+const affine::matrix& transform_store::matrix(entity_type entity) const
+{
+    return matrices_[slot_(entity)];
+}
+
+const std::vector<transform_store::entity_type>& transform_store::entities() const noexcept
+{
+    return entities_;
+}
+
+const std::vector<affine::matrix>& transform_store::matrices() const noexcept
+{
+    return matrices_;
+}
+
+transform_store::arrays transform_store::data() const noexcept
+{
+    return {
+        { position_[0].data(), position_[1].data(), position_[2].data() },
+        { rotation_[0].data(), rotation_[1].data(), rotation_[2].data(), rotation_[3].data() },
+        { scale_[0].data(), scale_[1].data(), scale_[2].data() }
+    };
+}
+
+void transform_store::compose(const arrays& input, std::size_t count, affine::matrix* output)
+{
+    for (std::size_t first = 0; first < count; first += LANE_COUNT) {
+        const std::size_t lanes = std::min(LANE_COUNT, count - first);
+
+        // The upper 3x4 of each matrix, column major, one lane per entity.
+        float m[12][LANE_COUNT];
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            const std::size_t i = first + lane;
+            const float x = input.rotation[0][i];
+            const float y = input.rotation[1][i];
+            const float z = input.rotation[2][i];
+            const float w = input.rotation[3][i];
+            const float sx = input.scale[0][i];
+            const float sy = input.scale[1][i];
+            const float sz = input.scale[2][i];
+
+            m[0][lane] = (1.0f - 2.0f * (y * y + z * z)) * sx;
+            m[1][lane] = 2.0f * (x * y + w * z) * sx;
+            m[2][lane] = 2.0f * (x * z - w * y) * sx;
+            m[3][lane] = 2.0f * (x * y - w * z) * sy;
+            m[4][lane] = (1.0f - 2.0f * (x * x + z * z)) * sy;
+            m[5][lane] = 2.0f * (y * z + w * x) * sy;
+            m[6][lane] = 2.0f * (x * z + w * y) * sz;
+            m[7][lane] = 2.0f * (y * z - w * x) * sz;
+            m[8][lane] = (1.0f - 2.0f * (x * x + y * y)) * sz;
+            m[9][lane] = input.position[0][i];
+            m[10][lane] = input.position[1][i];
+            m[11][lane] = input.position[2][i];
+        }
+
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            auto& out = output[first + lane];
+            out[0] = { m[0][lane], m[3][lane], m[6][lane], m[9][lane] };
+            out[1] = { m[1][lane], m[4][lane], m[7][lane], m[10][lane] };
+            out[2] = { m[2][lane], m[5][lane], m[8][lane], m[11][lane] };
+        }
+    }
+}
+
+std::uint32_t transform_store::slot_(entity_type entity) const
+{
+    return slots_.at(entity);
+}
+}
@@ -0,0 +1,191 @@
+#include <sigma/transform_system.hpp>
+
+#include <sigma/util/parallel.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace sigma {
+namespace {
+    constexpr std::size_t ROOT_GRAIN_SIZE = 16;
+}
+
+void transform_system::set_parent(entt::registry<>& registry, entity_type child, entity_type parent)
+{
+    if (parent == hierarchy::NO_PARENT) {
+        remove_parent(registry, child);
+        return;
+    }
+
+    for (entity_type ancestor = parent;;) {
+        if (ancestor == child)
+            throw std::invalid_argument("an entity can not be parented to itself or one of its descendants");
+        if (!registry.has<hierarchy>(ancestor))
+            break;
+        ancestor = registry.get<hierarchy>(ancestor).parent;
+    }
+
+    registry.assign_or_replace<hierarchy>(child, parent);
+    if (registry.has<transform>(child))
+        registry.get<transform>(child).dirty = true;
+    order_dirty_ = true;
+}
+
+void transform_system::remove_parent(entt::registry<>& registry, entity_type child)
+{
+    if (!registry.has<hierarchy>(child))
+        return;
+
+    registry.remove<hierarchy>(child);
+    if (registry.has<transform>(child))
+        registry.get<transform>(child).dirty = true;
+    order_dirty_ = true;
+}
+
+void transform_system::invalidate() noexcept
+{
+    order_dirty_ = true;
+}
+
+void transform_system::update(entt::registry<>& registry)
+{
+    changed_.clear();
+
+    auto transforms = registry.view<transform>();
+    auto hierarchies = registry.view<hierarchy>();
+    if (order_dirty_ || hierarchies.size() != hierarchy_count_)
+        rebuild_order_(registry);
+
+    dirty_roots_.clear();
+    transforms.each([&](auto entity, const transform& t) {
+        if (t.dirty)
+            dirty_roots_.push_back(entity);
+    });
+    if (dirty_roots_.empty())
+        return;
+
+    // Flags are only cleared once every subtree is done, so a dirty
+    // transform below another one is found before either is updated.
+    dirty_roots_.erase(std::remove_if(dirty_roots_.begin(), dirty_roots_.end(), [&](entity_type entity) {
+        return has_dirty_ancestor_(registry, entity);
+    }),
+        dirty_roots_.end());
+
+    std::mutex changed_mutex;
+    util::parallel_for(dirty_roots_.size(), ROOT_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+        std::vector<entity_type> stack;
+        std::vector<entity_type> changed;
+        for (std::size_t i = begin; i < end; ++i)
+            update_subtree_(registry, dirty_roots_[i], stack, changed);
+
+        std::lock_guard<std::mutex> lock { changed_mutex };
+        changed_.insert(changed_.end(), changed.begin(), changed.end());
+    });
+
+    for (auto entity : changed_)
+        registry.get<transform>(entity).dirty = false;
+}
+
+const std::vector<transform_system::entity_type>& transform_system::changed() const noexcept
+{
+    return changed_;
+}
+
+void transform_system::rebuild_order_(entt::registry<>& registry)
+{
+    auto hierarchies = registry.view<hierarchy>();
+
+    // Depth of a parent link is one more than the depth of the parent, the
+    // chain is walked up to the first entity with a known depth.
+    std::unordered_map<entity_type, std::uint32_t> depths;
+    std::vector<entity_type> chain;
+    for (auto entity : hierarchies) {
+        chain.clear();
+        std::uint32_t depth = 0;
+        for (entity_type e = entity;;) {
+            auto known = depths.find(e);
+            if (known != depths.end()) {
+                depth = known->second;
+                break;
+            }
+            if (!registry.has<hierarchy>(e))
+                break;
+            if (chain.size() > hierarchies.size())
+                throw std::logic_error("the transform hierarchy contains a cycle");
+            chain.push_back(e);
+
+            const entity_type parent = registry.get<hierarchy>(e).parent;
+            if (parent == hierarchy::NO_PARENT || !registry.valid(parent))
+                break;
+            e = parent;
+        }
+
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            depths[*it] = ++depth;
+            registry.get<hierarchy>(*it).depth = depth;
+        }
+    }
+
+    registry.sort<hierarchy>([](const hierarchy& lhs, const hierarchy& rhs) {
+        return lhs.depth < rhs.depth;
+    });
+
+    children_.assign(hierarchies.begin(), hierarchies.end());
+    std::stable_sort(children_.begin(), children_.end(), [&registry](entity_type lhs, entity_type rhs) {
+        return registry.get<hierarchy>(lhs).parent < registry.get<hierarchy>(rhs).parent;
+    });
+
+    child_ranges_.clear();
+    for (std::size_t begin = 0, end; begin < children_.size(); begin = end) {
+        const entity_type parent = registry.get<hierarchy>(children_[begin]).parent;
+        for (end = begin + 1; end < children_.size() && registry.get<hierarchy>(children_[end]).parent == parent; ++end)
+            ;
+        child_ranges_[parent] = { begin, end };
+    }
+
+    hierarchy_count_ = hierarchies.size();
+    order_dirty_ = false;
+}
+
+bool transform_system::has_dirty_ancestor_(entt::registry<>& registry, entity_type entity) const
+{
+    // Changes do not propagate past an ancestor without a transform.
+    while (registry.has<hierarchy>(entity)) {
+        entity = registry.get<hierarchy>(entity).parent;
+        if (!registry.valid(entity) || !registry.has<transform>(entity))
+            return false;
+        if (registry.get<transform>(entity).dirty)
+            return true;
+    }
+    return false;
+}
+
+void transform_system::update_subtree_(entt::registry<>& registry, entity_type root, std::vector<entity_type>& stack, std::vector<entity_type>& changed) const
+{
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const entity_type entity = stack.back();
+        stack.pop_back();
+
+        auto& t = registry.get<transform>(entity);
+        const transform* parent_transform = nullptr;
+        if (registry.has<hierarchy>(entity)) {
+            const entity_type parent = registry.get<hierarchy>(entity).parent;
+            if (registry.valid(parent) && registry.has<transform>(parent))
+                parent_transform = &registry.get<transform>(parent);
+        }
+        t.matrix = parent_transform ? affine::multiply(parent_transform->matrix, t.get_affine()) : t.get_affine();
+        changed.push_back(entity);
+
+        auto children = child_ranges_.find(entity);
+        if (children == child_ranges_.end())
+            continue;
+        for (std::size_t i = children->second.first; i < children->second.second; ++i) {
+            if (registry.has<transform>(children_[i]))
+                stack.push_back(children_[i]);
+        }
+    }
+}
+}
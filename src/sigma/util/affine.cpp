@@ -0,0 +1,32 @@
+#include <sigma/util/affine.hpp>
+
+#include <glm/geometric.hpp>
+
+namespace sigma {
+namespace affine {
+    void multiply(const matrix* a, const matrix* b, std::size_t count, matrix* output)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            output[i] = multiply(a[i], b[i]);
+    }
+
+    void multiply(const matrix& parent, const matrix* b, std::size_t count, matrix* output)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            output[i] = multiply(parent, b[i]);
+    }
+
+    void transform_points(const matrix& a, const glm::vec3* points, std::size_t count, glm::vec3* output)
+    {
+        // Rows are broadcast once, each point is then three dot products.
+        const glm::vec3 x { a[0] };
+        const glm::vec3 y { a[1] };
+        const glm::vec3 z { a[2] };
+        const glm::vec3 t = translation(a);
+        for (std::size_t i = 0; i < count; ++i) {
+            const glm::vec3& p = points[i];
+            output[i] = glm::vec3 { glm::dot(x, p), glm::dot(y, p), glm::dot(z, p) } + t;
+        }
+    }
+}
+}
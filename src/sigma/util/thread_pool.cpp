@@ -0,0 +1,115 @@
+#include <sigma/util/thread_pool.hpp>
+
+#include <utility>
+
+namespace sigma {
+namespace util {
+    namespace {
+        // Set while a thread runs a pool job so nested calls do not wait for
+        // the job they are part of.
+        thread_local bool in_job = false;
+        thread_local std::size_t current_worker = 0;
+    }
+
+    thread_pool::thread_pool(std::size_t thread_count)
+    {
+        thread_count = std::max<std::size_t>(thread_count, 1);
+        threads_.reserve(thread_count - 1);
+        for (std::size_t i = 1; i < thread_count; ++i)
+            threads_.emplace_back([this, i] { work_(i); });
+    }
+
+    thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            stopping_ = true;
+        }
+        start_.notify_all();
+        for (auto& thread : threads_)
+            thread.join();
+    }
+
+    std::size_t thread_pool::size() const noexcept
+    {
+        return threads_.size() + 1;
+    }
+
+    void thread_pool::run(std::size_t count, const std::function<void(std::size_t)>& job)
+    {
+        count = std::min(count, size());
+        if (count == 0)
+            return;
+
+        if (in_job) {
+            job(current_worker);
+            return;
+        }
+
+        if (count == 1) {
+            job(0);
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock { run_mutex_ };
+        {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            job_ = &job;
+            participants_ = count;
+            pending_ = count - 1;
+            generation_++;
+        }
+        start_.notify_all();
+
+        call_(0);
+
+        std::unique_lock<std::mutex> lock { mutex_ };
+        done_.wait(lock, [this] { return pending_ == 0; });
+        job_ = nullptr;
+        if (error_)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+    thread_pool& thread_pool::instance()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    void thread_pool::work_(std::size_t worker)
+    {
+        std::uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock { mutex_ };
+        while (true) {
+            start_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_)
+                return;
+
+            seen = generation_;
+            if (worker >= participants_)
+                continue;
+
+            lock.unlock();
+            call_(worker);
+            lock.lock();
+
+            if (--pending_ == 0)
+                done_.notify_one();
+        }
+    }
+
+    void thread_pool::call_(std::size_t worker)
+    {
+        in_job = true;
+        current_worker = worker;
+        try {
+            (*job_)(worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            if (!error_)
+                error_ = std::current_exception();
+        }
+        in_job = false;
+    }
+}
+}
@@ -0,0 +1,59 @@
+#include <sigma/util/affine.hpp>
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+void expect_near(const glm::mat4& expected, const glm::mat4& actual)
+{
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r)
+            EXPECT_NEAR(expected[c][r], actual[c][r], 1e-4f);
+    }
+}
+
+glm::mat4 make_matrix(float angle, const glm::vec3& axis, const glm::vec3& position, const glm::vec3& scale)
+{
+    return glm::translate(glm::mat4(1), position) * glm::mat4_cast(glm::angleAxis(angle, axis)) * glm::scale(glm::mat4(1), scale);
+}
+}
+
+TEST(affine, round_trips_through_mat4)
+{
+    glm::mat4 m = make_matrix(0.7f, { 0, 1, 0 }, { 1, 2, 3 }, { 2, 2, 2 });
+    expect_near(m, sigma::affine::to_mat4(sigma::affine::from_mat4(m)));
+}
+
+TEST(affine, compose_matches_mat4)
+{
+    glm::quat rotation = glm::angleAxis(1.1f, glm::vec3 { 0.6f, 0.0f, 0.8f });
+    expect_near(make_matrix(1.1f, { 0.6f, 0.0f, 0.8f }, { -4, 5, 6 }, { 1, 2, 3 }),
+        sigma::affine::to_mat4(sigma::affine::compose({ -4, 5, 6 }, rotation, { 1, 2, 3 })));
+}
+
+TEST(affine, multiply_matches_mat4)
+{
+    glm::mat4 a = make_matrix(0.3f, { 1, 0, 0 }, { 1, 0, 0 }, { 1, 2, 1 });
+    glm::mat4 b = make_matrix(-1.2f, { 0, 0, 1 }, { 0, 5, -2 }, { 3, 1, 1 });
+    auto product = sigma::affine::multiply(sigma::affine::from_mat4(a), sigma::affine::from_mat4(b));
+    expect_near(a * b, sigma::affine::to_mat4(product));
+
+    glm::mat4 projection = glm::perspective(1.0f, 1.5f, 0.1f, 100.0f);
+    expect_near(projection * b, sigma::affine::multiply(projection, sigma::affine::from_mat4(b)));
+}
+
+TEST(affine, transform_points_matches_mat4)
+{
+    glm::mat4 m = make_matrix(0.5f, { 0, 1, 0 }, { 1, 2, 3 }, { 1, 1, 2 });
+    std::vector<glm::vec3> points = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 3, -2, 7 } };
+    std::vector<glm::vec3> output(points.size());
+    sigma::affine::transform_points(sigma::affine::from_mat4(m), points.data(), points.size(), output.data());
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        glm::vec4 expected = m * glm::vec4 { points[i], 1.0f };
+        EXPECT_NEAR(expected.x, output[i].x, 1e-4f);
+        EXPECT_NEAR(expected.y, output[i].y, 1e-4f);
+        EXPECT_NEAR(expected.z, output[i].z, 1e-4f);
+    }
+}
@@ -0,0 +1,104 @@
+#include <sigma/broad_phase.hpp>
+
+#include "random_boxes.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+std::vector<sigma::broad_phase::pair> brute_force_pairs(const std::vector<sigma::AABB>& boxes)
+{
+    std::vector<sigma::broad_phase::pair> pairs;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i) {
+        for (std::uint32_t j = i + 1; j < boxes.size(); ++j) {
+            if (boxes[i].collides(boxes[j]))
+                pairs.push_back({ i, j });
+        }
+    }
+    return pairs;
+}
+}
+
+TEST(broad_phase, finds_the_same_pairs_as_brute_force)
+{
+    for (auto axis : { sigma::broad_phase::axis::x, sigma::broad_phase::axis::z, sigma::broad_phase::axis::automatic }) {
+        auto boxes = sigma::test::random_boxes(500, 7, 50.0f, 0.5f, 6.0f);
+        sigma::broad_phase phase { axis };
+        for (std::uint32_t i = 0; i < boxes.size(); ++i)
+            phase.insert(i, boxes[i]);
+        phase.sweep();
+
+        EXPECT_EQ(brute_force_pairs(boxes), phase.pairs());
+    }
+}
+
+TEST(broad_phase, pairs_stay_correct_as_objects_move)
+{
+    auto boxes = sigma::test::random_boxes(300, 11, 50.0f, 0.5f, 6.0f);
+    sigma::broad_phase phase;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+        phase.insert(i, boxes[i]);
+    phase.sweep();
+
+    std::mt19937 rng { 3 };
+    std::uniform_real_distribution<float> step { -2.0f, 2.0f };
+    for (int frame = 0; frame < 10; ++frame) {
+        auto previous = phase.pairs();
+        for (std::uint32_t i = 0; i < boxes.size(); ++i) {
+            boxes[i].set_center(boxes[i].center() + glm::vec3 { step(rng), step(rng), step(rng) });
+            phase.update(i, boxes[i]);
+        }
+        phase.sweep();
+
+        auto expected = brute_force_pairs(boxes);
+        EXPECT_EQ(expected, phase.pairs());
+
+        // Applying the events to the previous pairs gives the new ones.
+        std::vector<sigma::broad_phase::pair> rebuilt;
+        for (const auto& p : previous) {
+            if (std::find(phase.end_events().begin(), phase.end_events().end(), p) == phase.end_events().end())
+                rebuilt.push_back(p);
+        }
+        rebuilt.insert(rebuilt.end(), phase.begin_events().begin(), phase.begin_events().end());
+        EXPECT_EQ(expected.size(), rebuilt.size());
+    }
+}
+
+TEST(broad_phase, reports_begin_and_end_events)
+{
+    sigma::broad_phase phase { sigma::broad_phase::axis::x };
+    phase.insert(1, sigma::AABB { { 0, 0, 0 }, { 1, 1, 1 } });
+    phase.insert(2, sigma::AABB { { 5, 0, 0 }, { 1, 1, 1 } });
+    phase.sweep();
+    EXPECT_TRUE(phase.pairs().empty());
+
+    phase.update(2, sigma::AABB { { 0.5f, 0, 0 }, { 1, 1, 1 } });
+    phase.sweep();
+    ASSERT_EQ(1u, phase.begin_events().size());
+    EXPECT_EQ((sigma::broad_phase::pair { 1, 2 }), phase.begin_events()[0]);
+    EXPECT_TRUE(phase.end_events().empty());
+
+    phase.sweep();
+    EXPECT_TRUE(phase.begin_events().empty());
+    EXPECT_EQ(1u, phase.pairs().size());
+
+    phase.remove(1);
+    phase.sweep();
+    ASSERT_EQ(1u, phase.end_events().size());
+    EXPECT_EQ((sigma::broad_phase::pair { 1, 2 }), phase.end_events()[0]);
+    EXPECT_TRUE(phase.pairs().empty());
+}
+
+TEST(broad_phase, removed_slots_are_reused)
+{
+    sigma::broad_phase phase;
+    phase.insert(1, sigma::AABB { { 0, 0, 0 }, { 1, 1, 1 } });
+    phase.insert(2, sigma::AABB { { 0, 0, 0 }, { 1, 1, 1 } });
+    phase.remove(2);
+    phase.insert(3, sigma::AABB { { 0, 0, 0 }, { 1, 1, 1 } });
+    phase.sweep();
+
+    EXPECT_EQ(2u, phase.size());
+    EXPECT_EQ((std::vector<sigma::broad_phase::pair> { { 1, 3 } }), phase.pairs());
+}
@@ -0,0 +1,144 @@
+#include <sigma/bvh.hpp>
+
+#include "random_boxes.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+std::vector<std::uint32_t> sorted(std::vector<std::uint32_t> v)
+{
+    std::sort(v.begin(), v.end());
+    return v;
+}
+}
+
+TEST(bvh, empty_bvh_query_visits_nothing)
+{
+    sigma::bvh tree;
+    tree.build(std::vector<sigma::AABB> {});
+
+    bool visited = false;
+    tree.query(sigma::AABB { { 0, 0, 0 }, { 10, 10, 10 } }, [&](std::uint32_t) { visited = true; });
+
+    EXPECT_TRUE(tree.empty());
+    EXPECT_FALSE(visited);
+}
+
+TEST(bvh, build_references_every_primitive_once)
+{
+    auto boxes = sigma::test::random_boxes(10000, 1, 100.0f, 0.1f, 4.0f);
+    sigma::bvh tree;
+    tree.build(boxes);
+
+    auto indices = sorted(tree.indices());
+    ASSERT_EQ(boxes.size(), indices.size());
+    for (std::uint32_t i = 0; i < indices.size(); ++i)
+        EXPECT_EQ(i, indices[i]);
+}
+
+TEST(bvh, box_query_matches_brute_force)
+{
+    auto boxes = sigma::test::random_boxes(10000, 2, 100.0f, 0.1f, 4.0f);
+    sigma::bvh tree;
+    tree.build(boxes);
+
+    sigma::AABB query { { 10, -5, 20 }, { 30, 40, 25 } };
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i) {
+        if (query.collides(boxes[i]))
+            expected.push_back(i);
+    }
+
+    std::vector<std::uint32_t> found;
+    tree.query(query, [&](std::uint32_t i) { found.push_back(i); });
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, sorted(found));
+}
+
+TEST(bvh, frustum_query_matches_brute_force)
+{
+    auto boxes = sigma::test::random_boxes(10000, 3, 100.0f, 0.1f, 4.0f);
+    sigma::bvh tree;
+    tree.build(boxes);
+
+    sigma::frustum view { glm::radians(60.0f), 1.0f, 0.1f, 80.0f, glm::lookAt(glm::vec3 { 0, 0, 0 }, glm::vec3 { 1, 0, 1 }, glm::vec3 { 0, 1, 0 }) };
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i) {
+        if (view.contains_box(boxes[i]))
+            expected.push_back(i);
+    }
+
+    std::vector<std::uint32_t> found;
+    tree.query(view, [&](std::uint32_t i) { found.push_back(i); });
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, sorted(found));
+}
+
+TEST(bvh, raycast_with_closest_hit_returns_nearest_box)
+{
+    std::vector<sigma::AABB> boxes = {
+        { { 0, 0, -10 }, { 1, 1, 1 } },
+        { { 0, 0, -5 }, { 1, 1, 1 } },
+        { { 5, 0, -5 }, { 1, 1, 1 } },
+        { { 0, 0, -20 }, { 1, 1, 1 } },
+        { { 0, 0, 5 }, { 1, 1, 1 } }
+    };
+    sigma::bvh tree;
+    tree.build(boxes);
+
+    float max_distance = 100.0f;
+    std::uint32_t closest = static_cast<std::uint32_t>(-1);
+    tree.raycast({ 0, 0, 0 }, { 0, 0, -1 }, max_distance, [&](std::uint32_t i, float& distance) {
+        float hit = -boxes[i].max().z;
+        if (hit < distance) {
+            distance = hit;
+            closest = i;
+        }
+    });
+
+    EXPECT_EQ(1, closest);
+    EXPECT_NEAR(4.5f, max_distance, 1e-5f);
+}
+
+TEST(bvh, refit_moves_primitive_to_new_location)
+{
+    auto boxes = sigma::test::random_boxes(1000, 4, 100.0f, 0.1f, 4.0f);
+    sigma::bvh tree;
+    tree.build(boxes);
+
+    sigma::AABB moved { { 500, 500, 500 }, { 1, 1, 1 } };
+    tree.update(7, moved);
+    tree.refit();
+
+    std::vector<std::uint32_t> found;
+    tree.query(moved, [&](std::uint32_t i) { found.push_back(i); });
+
+    ASSERT_EQ(1, found.size());
+    EXPECT_EQ(7, found[0]);
+}
+
+TEST(bvh, needs_rebuild_after_primitives_scatter)
+{
+    auto boxes = sigma::test::random_boxes(1000, 5, 100.0f, 0.1f, 4.0f);
+    sigma::bvh tree;
+    tree.build(boxes);
+    EXPECT_FALSE(tree.needs_rebuild());
+
+    auto scattered = sigma::test::random_boxes(1000, 6, 100.0f, 0.1f, 4.0f);
+    for (std::uint32_t i = 0; i < scattered.size(); ++i)
+        tree.update(i, scattered[i]);
+    tree.refit();
+
+    EXPECT_TRUE(tree.needs_rebuild());
+
+    tree.build(scattered);
+    EXPECT_FALSE(tree.needs_rebuild());
+}
@@ -0,0 +1,94 @@
+#include <sigma/frame_allocator.hpp>
+#include <sigma/util/parallel.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+TEST(frame_allocator, allocations_are_aligned_and_do_not_overlap)
+{
+    sigma::frame_allocator allocator { 256 };
+
+    auto a = allocator.allocate<char>(3);
+    auto b = allocator.allocate<double>(4);
+    auto c = allocator.allocate(16, 64);
+
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(b) % alignof(double));
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(c) % 64);
+    EXPECT_LE(reinterpret_cast<std::uintptr_t>(a + 3), reinterpret_cast<std::uintptr_t>(b));
+    EXPECT_LE(reinterpret_cast<std::uintptr_t>(b + 4), reinterpret_cast<std::uintptr_t>(c));
+    EXPECT_EQ(3u + 4 * sizeof(double) + 16, allocator.used());
+}
+
+TEST(frame_allocator, large_allocations_chain_blocks)
+{
+    sigma::frame_allocator allocator { 64 };
+
+    auto a = allocator.allocate<std::uint32_t>(100);
+    auto b = allocator.allocate<std::uint32_t>(100);
+    for (int i = 0; i < 100; ++i) {
+        a[i] = i;
+        b[i] = 100 + i;
+    }
+
+    EXPECT_EQ(99u, a[99]);
+    EXPECT_EQ(100u, b[0]);
+    EXPECT_EQ(800u, allocator.used());
+}
+
+TEST(frame_allocator, memory_is_reused_after_frame_count_frames)
+{
+    sigma::frame_allocator allocator { 1024 };
+
+    auto first = allocator.allocate(128);
+    for (std::size_t i = 0; i < sigma::frame_allocator::FRAME_COUNT - 1; ++i) {
+        allocator.begin_frame();
+        EXPECT_NE(first, allocator.allocate(128));
+    }
+
+    allocator.begin_frame();
+    EXPECT_EQ(first, allocator.allocate(128));
+    EXPECT_EQ(128u, allocator.used());
+}
+
+TEST(frame_allocator, threads_use_separate_sub_arenas)
+{
+    sigma::frame_allocator allocator { 1024, 2 };
+
+    auto a = static_cast<char*>(allocator.allocate(16, 1, 0));
+    auto b = static_cast<char*>(allocator.allocate(16, 1, 1));
+
+    EXPECT_NE(a + 16, b);
+    EXPECT_THROW(allocator.allocate(16, 1, 2), std::out_of_range);
+}
+
+TEST(frame_allocator, arena_allocator_backs_standard_containers)
+{
+    sigma::frame_allocator allocator { 4096 };
+
+    std::vector<int, sigma::arena_allocator<int>> values { sigma::arena_allocator<int> { allocator } };
+    for (int i = 0; i < 100; ++i)
+        values.push_back(i);
+
+    EXPECT_EQ(99, values.back());
+    EXPECT_GE(allocator.used(), 100 * sizeof(int));
+}
+
+TEST(frame_allocator, parallel_for_workers_fill_their_own_sub_arena)
+{
+    sigma::frame_allocator allocator { 4096, sigma::util::worker_count() };
+    std::vector<std::atomic<int>> visits(1000);
+
+    sigma::util::parallel_for(visits.size(), 10, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+        ASSERT_LT(worker, allocator.thread_count());
+        sigma::frame_vector<std::size_t> indices { sigma::arena_allocator<std::size_t> { allocator, worker } };
+        for (std::size_t i = begin; i < end; ++i)
+            indices.push_back(i);
+        for (auto i : indices)
+            visits[i]++;
+    });
+
+    for (const auto& v : visits)
+        EXPECT_EQ(1, v);
+}
@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/trigonometric.hpp>
 
 TEST(frustum, perspective_corners_are_where_they_should_be)
@@ -53,51 +54,92 @@ TEST(frustum, perspective_corners_are_where_they_should_be)
     EXPECT_NEAR(-100.0f, corners[7].z, 10e-5f);
 }
 
-// TEST(frustum, orthographics_corners_are_where_they_should_be)
-// {
-//     auto f = sigma::frustum(-40, 40, -30, 30, -33, 33);
-//
-//     auto corners = f.corners();
-//     // Near plane
-//
-//     // Bottom left
-//     EXPECT_NEAR(-40.0f, corners[0].x, 10e-5f);
-//     EXPECT_NEAR(-30.0f, corners[0].y, 10e-5f);
-//     EXPECT_NEAR(33.0f, corners[0].z, 10e-5f);
-//
-//     // Top left
-//     EXPECT_NEAR(-40.0f, corners[1].x, 10e-5f);
-//     EXPECT_NEAR(30.0f, corners[1].y, 10e-5f);
-//     EXPECT_NEAR(33.0f, corners[1].z, 10e-5f);
-//
-//     // Top right
-//     EXPECT_NEAR(40.0f, corners[2].x, 10e-5f);
-//     EXPECT_NEAR(30.0f, corners[2].y, 10e-5f);
-//     EXPECT_NEAR(33.0f, corners[2].z, 10e-5f);
-//
-//     // Bottom right
-//     EXPECT_NEAR(40.0f, corners[3].x, 10e-5f);
-//     EXPECT_NEAR(-30.0f, corners[3].y, 10e-5f);
-//     EXPECT_NEAR(33.0f, corners[3].z, 10e-5f);
-//
-//     // Far plane
-//
-//     // Bottom left
-//     EXPECT_NEAR(-40.0f, corners[4].x, 10e-5f);
-//     EXPECT_NEAR(-30.0f, corners[4].y, 10e-5f);
-//     EXPECT_NEAR(-33.0f, corners[4].z, 10e-5f);
-//
-//     // Top left
-//     EXPECT_NEAR(-40.0f, corners[5].x, 10e-5f);
-//     EXPECT_NEAR(30.0f, corners[5].y, 10e-5f);
-//     EXPECT_NEAR(-33.0f, corners[5].z, 10e-5f);
-//     // Top right
-//     EXPECT_NEAR(40.0f, corners[6].x, 10e-5f);
-//     EXPECT_NEAR(30.0f, corners[6].y, 10e-5f);
-//     EXPECT_NEAR(-33.0f, corners[6].z, 10e-5f);
-//
-//     // Bottom right
-//     EXPECT_NEAR(40.0f, corners[7].x, 10e-5f);
-//     EXPECT_NEAR(-30.0f, corners[7].y, 10e-5f);
-//     EXPECT_NEAR(-33.0f, corners[7].z, 10e-5f);
-// }
+TEST(frustum, orthographics_corners_are_where_they_should_be)
+{
+    auto f = sigma::frustum(-40, 40, -30, 30, -33, 33);
+
+    auto corners = f.corners();
+    // Near plane
+
+    // Bottom left
+    EXPECT_NEAR(-40.0f, corners[0].x, 10e-5f);
+    EXPECT_NEAR(-30.0f, corners[0].y, 10e-5f);
+    EXPECT_NEAR(33.0f, corners[0].z, 10e-5f);
+
+    // Top left
+    EXPECT_NEAR(-40.0f, corners[1].x, 10e-5f);
+    EXPECT_NEAR(30.0f, corners[1].y, 10e-5f);
+    EXPECT_NEAR(33.0f, corners[1].z, 10e-5f);
+
+    // Top right
+    EXPECT_NEAR(40.0f, corners[2].x, 10e-5f);
+    EXPECT_NEAR(30.0f, corners[2].y, 10e-5f);
+    EXPECT_NEAR(33.0f, corners[2].z, 10e-5f);
+
+    // Bottom right
+    EXPECT_NEAR(40.0f, corners[3].x, 10e-5f);
+    EXPECT_NEAR(-30.0f, corners[3].y, 10e-5f);
+    EXPECT_NEAR(33.0f, corners[3].z, 10e-5f);
+
+    // Far plane
+
+    // Bottom left
+    EXPECT_NEAR(-40.0f, corners[4].x, 10e-5f);
+    EXPECT_NEAR(-30.0f, corners[4].y, 10e-5f);
+    EXPECT_NEAR(-33.0f, corners[4].z, 10e-5f);
+
+    // Top left
+    EXPECT_NEAR(-40.0f, corners[5].x, 10e-5f);
+    EXPECT_NEAR(30.0f, corners[5].y, 10e-5f);
+    EXPECT_NEAR(-33.0f, corners[5].z, 10e-5f);
+    // Top right
+    EXPECT_NEAR(40.0f, corners[6].x, 10e-5f);
+    EXPECT_NEAR(30.0f, corners[6].y, 10e-5f);
+    EXPECT_NEAR(-33.0f, corners[6].z, 10e-5f);
+
+    // Bottom right
+    EXPECT_NEAR(40.0f, corners[7].x, 10e-5f);
+    EXPECT_NEAR(-30.0f, corners[7].y, 10e-5f);
+    EXPECT_NEAR(-33.0f, corners[7].z, 10e-5f);
+}
+
+TEST(frustum, inverse_projection_view_matches_general_inverse)
+{
+    auto view = glm::lookAt(glm::vec3 { 3, 4, 5 }, glm::vec3 { 0, 1, 0 }, glm::vec3 { 0, 1, 0 });
+    sigma::frustum perspective { glm::radians(70.0f), 1.6f, 0.5f, 200.0f, view };
+    sigma::frustum orthographic { -10, 20, -5, 15, 1, 50, view };
+
+    for (const auto& f : { perspective, orthographic }) {
+        auto expected = glm::inverse(f.projection_view());
+        auto actual = f.inverse_projection_view();
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r)
+                EXPECT_NEAR(expected[c][r], actual[c][r], 10e-4f);
+        }
+    }
+}
+
+TEST(frustum, batch_build_matches_individual_construction)
+{
+    sigma::perspective_batch batch;
+    for (int i = 0; i < 10; ++i) {
+        auto view = glm::lookAt(glm::vec3 { i + 1, 2, -i - 3 }, glm::vec3 { 0, 0, 0 }, glm::vec3 { 0, 1, 0 });
+        batch.push_back(glm::radians(30.0f + 5.0f * i), 1.0f + 0.1f * i, 0.1f * (i + 1), 50.0f + i, view);
+    }
+
+    std::vector<sigma::frustum> frustums(batch.size());
+    sigma::frustum::build(batch, frustums.data());
+
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        sigma::frustum expected { batch.fovy[i], batch.aspect[i], batch.z_near[i], batch.z_far[i], batch.view[i] };
+        for (int p = 0; p < 6; ++p) {
+            for (int k = 0; k < 4; ++k)
+                EXPECT_NEAR(expected.planes()[p][k], frustums[i].planes()[p][k], 10e-5f);
+        }
+        for (int c = 0; c < 8; ++c) {
+            for (int k = 0; k < 3; ++k)
+                EXPECT_NEAR(expected.corners()[c][k], frustums[i].corners()[c][k], 10e-3f);
+        }
+        EXPECT_NEAR(expected.radius(), frustums[i].radius(), 10e-3f);
+    }
+}
@@ -0,0 +1,76 @@
+#include <sigma/graphics/cascade_builder.hpp>
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+sigma::frustum make_camera(const glm::vec3& eye, const glm::vec3& target)
+{
+    return { glm::radians(60.0f), 1.0f, 0.1f, 100.0f, glm::lookAt(eye, target, { 0, 1, 0 }) };
+}
+}
+
+TEST(cascade_builder, splits_increase_to_far_plane)
+{
+    sigma::graphics::cascade_builder builder { 4 };
+    builder.update(make_camera({ 0, 2, 0 }, { 0, 2, -1 }), { 0, -1, -0.5f }, {}, 0);
+
+    EXPECT_EQ(4u, builder.block().cascade_count);
+    for (std::size_t i = 1; i < 4; ++i)
+        EXPECT_LT(builder.split(i - 1), builder.split(i));
+    EXPECT_NEAR(100.0f, builder.split(3), 1e-3f);
+}
+
+TEST(cascade_builder, cascade_count_is_limited)
+{
+    sigma::graphics::cascade_builder builder;
+    EXPECT_THROW(builder.set_cascade_count(0), std::out_of_range);
+    EXPECT_THROW(builder.set_cascade_count(sigma::graphics::MAX_SHADOW_CASCADES + 1), std::out_of_range);
+}
+
+TEST(cascade_builder, sub_texel_camera_movement_is_stable)
+{
+    sigma::graphics::cascade_builder builder { 3, 1024 };
+    builder.update(make_camera({ 0, 2, 0 }, { 0, 2, -1 }), { 0.3f, -1, -0.5f }, {}, 0);
+    glm::mat4 before = builder.projection_view(0);
+
+    builder.invalidate();
+    builder.update(make_camera({ 0, 2, 1e-4f }, { 0, 2, -1 + 1e-4f }), { 0.3f, -1, -0.5f }, {}, 1);
+    glm::mat4 after = builder.projection_view(0);
+
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r)
+            EXPECT_FLOAT_EQ(before[c][r], after[c][r]);
+    }
+}
+
+TEST(cascade_builder, casters_extend_depth_range)
+{
+    sigma::graphics::cascade_builder builder { 1 };
+    sigma::frustum camera = make_camera({ 0, 2, 0 }, { 0, 2, -1 });
+    builder.update(camera, { 0, -1, 0 }, { sigma::AABB { { 0, 500, -50 }, { 1, 1, 1 } } }, 0);
+
+    // The caster high above the camera must land inside the depth range.
+    glm::vec4 clip = builder.projection_view(0) * glm::vec4 { 0, 500, -50, 1 };
+    EXPECT_GE(clip.z, -1.0f - 1e-4f);
+    EXPECT_LE(clip.z, 1.0f + 1e-4f);
+}
+
+TEST(cascade_builder, distant_cascades_update_less_often)
+{
+    sigma::graphics::cascade_builder builder { 2 };
+    builder.set_update_interval(1, 4);
+    sigma::frustum camera = make_camera({ 0, 2, 0 }, { 0, 2, -1 });
+
+    builder.update(camera, { 0, -1, -0.5f }, {}, 0);
+    EXPECT_TRUE(builder.needs_render(1));
+
+    int updates = 0;
+    for (std::uint64_t frame = 1; frame <= 8; ++frame) {
+        builder.update(camera, { 0, -1, -0.5f }, {}, frame);
+        EXPECT_TRUE(builder.needs_render(0));
+        updates += builder.needs_render(1);
+    }
+    EXPECT_EQ(2, updates);
+}
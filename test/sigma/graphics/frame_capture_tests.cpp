@@ -0,0 +1,112 @@
+#include <sigma/graphics/frame_capture.hpp>
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace {
+sigma::graphics::view_port make_view()
+{
+    return { { 320, 240 }, sigma::frustum { glm::radians(60.0f), 4.0f / 3.0f, 0.1f, 100.0f, glm::lookAt(glm::vec3 { 0, 2, 5 }, glm::vec3 { 0 }, glm::vec3 { 0, 1, 0 }) } };
+}
+
+void record(sigma::graphics::render_queue& queue)
+{
+    queue.add_view(sigma::graphics::make_standard_block(make_view().view_frustum, { 320, 240 }, 0.0f));
+    queue.add_view(sigma::graphics::make_standard_block(sigma::frustum { glm::radians(90.0f), 1.0f, 0.1f, 50.0f }, { 512, 512 }, 0.0f));
+    for (int i = 0; i < 20; ++i) {
+        auto cmd = queue.enqueue(sigma::graphics::make_sort_key(0, i % 3, i % 5, i, 0.5f));
+        cmd->program = i % 3;
+        cmd->mesh = i;
+        cmd->count = 36;
+        cmd->input_textures[2] = i % 5;
+        cmd->buffer_bindings[1] = 7;
+        cmd->model = sigma::affine::compose({ float(i), 1, 2 }, {}, glm::vec3 { 1 });
+        cmd->view = i % 2;
+    }
+}
+
+bool same_command(const sigma::graphics::render_command& a, const sigma::graphics::render_command& b)
+{
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+}
+
+TEST(frame_capture, capture_keeps_enqueue_order)
+{
+    sigma::graphics::render_queue queue { 0 };
+    record(queue);
+
+    auto capture = sigma::graphics::frame_capture::capture(queue, make_view());
+
+    ASSERT_EQ(20u, capture.commands.size());
+    EXPECT_EQ(glm::ivec2(320, 240), capture.size);
+    for (std::size_t i = 0; i < capture.commands.size(); ++i) {
+        EXPECT_EQ(queue.entries()[i].key, capture.keys[i]);
+        EXPECT_TRUE(same_command(queue.commands()[i], capture.commands[i]));
+    }
+}
+
+TEST(frame_capture, saved_capture_replays_the_same_queue)
+{
+    sigma::graphics::render_queue queue { 0 };
+    record(queue);
+    auto capture = sigma::graphics::frame_capture::capture(queue, make_view(), [](sigma::graphics::resource_kind kind, std::uint64_t id) {
+        return kind == sigma::graphics::resource_kind::mesh && id == 3 ? std::string { "static_mesh/cube" } : std::string {};
+    });
+
+    auto path = std::filesystem::temp_directory_path() / "sigma_frame_capture_test.bin";
+    capture.save(path);
+    auto loaded = sigma::graphics::frame_capture::load(path);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(capture.view, loaded.view);
+    EXPECT_EQ(capture.projection, loaded.projection);
+    EXPECT_EQ("static_mesh/cube", loaded.resources.meshes[3]);
+    ASSERT_EQ(2u, loaded.views.size());
+    EXPECT_EQ(capture.views[1].projection_view_matrix, loaded.views[1].projection_view_matrix);
+    EXPECT_EQ(512.0f, loaded.views[1].view_port_size.x);
+
+    sigma::graphics::render_queue replayed { 0 };
+    loaded.replay(replayed);
+    ASSERT_EQ(queue.size(), replayed.size());
+    ASSERT_EQ(2u, replayed.views().size());
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        EXPECT_EQ(queue.entries()[i].key, replayed.entries()[i].key);
+        EXPECT_TRUE(same_command(queue.commands()[i], replayed.commands()[i]));
+    }
+}
+
+TEST(frame_capture, load_of_missing_file_throws)
+{
+    EXPECT_THROW(sigma::graphics::frame_capture::load("does/not/exist.bin"), std::runtime_error);
+}
+
+TEST(frame_capture, capture_resolves_every_referenced_id_once)
+{
+    sigma::graphics::render_queue queue { 0 };
+    record(queue);
+
+    std::map<std::pair<sigma::graphics::resource_kind, std::uint64_t>, int> lookups;
+    auto capture = sigma::graphics::frame_capture::capture(queue, make_view(), [&](sigma::graphics::resource_kind kind, std::uint64_t id) {
+        lookups[{ kind, id }]++;
+        return id == 0 ? std::string {} : std::to_string(id);
+    });
+
+    for (const auto& lookup : lookups)
+        EXPECT_EQ(1, lookup.second);
+    EXPECT_EQ(2u, capture.resources.programs.size());
+    EXPECT_EQ("2", capture.resources.programs[2]);
+    ASSERT_EQ(1u, capture.resources.buffers.size());
+    EXPECT_EQ("7", capture.resources.buffers[7]);
+    EXPECT_EQ(4u, capture.resources.textures.size());
+    EXPECT_EQ(19u, capture.resources.meshes.size());
+    EXPECT_EQ(0u, capture.resources.meshes.count(0));
+}
@@ -0,0 +1,163 @@
+#include <sigma/graphics/frame_graph.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+struct deferred_graph {
+    sigma::graphics::frame_graph graph;
+    std::vector<std::string> executed;
+    sigma::graphics::frame_graph::resource_handle albedo, normal, depth, shadow, hdr, bloom, debug, back_buffer;
+    sigma::graphics::frame_graph::pass_handle gbuffer_pass, shadow_pass, lighting_pass, debug_pass, bloom_pass, tonemap_pass;
+
+    deferred_graph()
+    {
+        const glm::ivec2 size { 1280, 720 };
+        auto record = [this](const std::string& name) {
+            return [this, name](const sigma::graphics::frame_graph&) { executed.push_back(name); };
+        };
+
+        back_buffer = graph.import("back_buffer");
+        gbuffer_pass = graph.add_pass("gbuffer", [&](auto& b) {
+            albedo = b.create_texture("albedo", size, 4);
+            normal = b.create_texture("normal", size, 8);
+            depth = b.create_texture("depth", size, 4);
+        },
+            record("gbuffer"));
+        shadow_pass = graph.add_pass("shadow", [&](auto& b) {
+            shadow = b.create_texture("shadow", { 2048, 2048 }, 4);
+        },
+            record("shadow"));
+        debug_pass = graph.add_pass("debug", [&](auto& b) {
+            b.read(normal);
+            debug = b.create_texture("debug", size, 4);
+        },
+            record("debug"));
+        lighting_pass = graph.add_pass("lighting", [&](auto& b) {
+            b.read(albedo);
+            b.read(normal);
+            b.read(depth);
+            b.read(shadow);
+            hdr = b.create_texture("hdr", size, 8);
+        },
+            record("lighting"));
+        bloom_pass = graph.add_pass("bloom", [&](auto& b) {
+            b.read(hdr);
+            bloom = b.create_texture("bloom", size, 8);
+        },
+            record("bloom"));
+        tonemap_pass = graph.add_pass("tonemap", [&](auto& b) {
+            b.read(hdr);
+            b.read(bloom);
+            b.write(back_buffer);
+        },
+            record("tonemap"));
+        graph.compile();
+    }
+};
+}
+
+TEST(frame_graph, passes_without_readers_are_culled)
+{
+    deferred_graph d;
+
+    EXPECT_TRUE(d.graph.culled(d.debug_pass));
+    EXPECT_FALSE(d.graph.culled(d.gbuffer_pass));
+    EXPECT_FALSE(d.graph.culled(d.tonemap_pass));
+    EXPECT_EQ(sigma::graphics::frame_graph::NO_OFFSET, d.graph.heap_offset(d.debug));
+}
+
+TEST(frame_graph, culling_follows_chains_and_keeps_side_effects)
+{
+    sigma::graphics::frame_graph graph;
+    sigma::graphics::frame_graph::resource_handle x;
+    auto a = graph.add_pass("a", [&](auto& b) { x = b.create_buffer("x", 16); }, {});
+    auto b = graph.add_pass("b", [&](auto& builder) { builder.read(x); builder.create_buffer("y", 16); }, {});
+    auto c = graph.add_pass("c", [&](auto& builder) { builder.side_effect(); }, {});
+    graph.compile();
+
+    EXPECT_TRUE(graph.culled(a));
+    EXPECT_TRUE(graph.culled(b));
+    EXPECT_FALSE(graph.culled(c));
+    EXPECT_EQ(std::vector<sigma::graphics::frame_graph::pass_handle> { c }, graph.order());
+}
+
+TEST(frame_graph, passes_execute_in_dependency_order)
+{
+    deferred_graph d;
+    d.graph.execute();
+
+    EXPECT_EQ((std::vector<std::string> { "gbuffer", "shadow", "lighting", "bloom", "tonemap" }), d.executed);
+
+    auto deps = d.graph.dependencies(d.lighting_pass);
+    std::sort(deps.begin(), deps.end());
+    EXPECT_EQ((std::vector<sigma::graphics::frame_graph::pass_handle> { d.gbuffer_pass, d.shadow_pass }), deps);
+    EXPECT_TRUE(d.graph.dependencies(d.shadow_pass).empty());
+}
+
+TEST(frame_graph, write_after_read_is_a_dependency)
+{
+    sigma::graphics::frame_graph graph;
+    auto out = graph.import("out");
+    sigma::graphics::frame_graph::resource_handle x;
+    auto first = graph.add_pass("first", [&](auto& b) { x = b.create_buffer("x", 16); b.write(out); }, {});
+    auto reader = graph.add_pass("reader", [&](auto& b) { b.read(x); b.write(out); }, {});
+    auto writer = graph.add_pass("writer", [&](auto& b) { b.write(x); b.write(out); }, {});
+    graph.compile();
+
+    const auto& deps = graph.dependencies(writer);
+    EXPECT_NE(deps.end(), std::find(deps.begin(), deps.end(), reader));
+    EXPECT_NE(deps.end(), std::find(deps.begin(), deps.end(), first));
+}
+
+TEST(frame_graph, resources_alive_at_the_same_time_do_not_share_memory)
+{
+    deferred_graph d;
+
+    EXPECT_LT(d.graph.heap_size(), d.graph.unaliased_size());
+    for (sigma::graphics::frame_graph::resource_handle a = 0; a < d.graph.resource_count(); ++a) {
+        for (sigma::graphics::frame_graph::resource_handle b = a + 1; b < d.graph.resource_count(); ++b) {
+            auto offset_a = d.graph.heap_offset(a);
+            auto offset_b = d.graph.heap_offset(b);
+            if (offset_a == sigma::graphics::frame_graph::NO_OFFSET || offset_b == sigma::graphics::frame_graph::NO_OFFSET)
+                continue;
+            bool overlap = offset_a < offset_b + d.graph.resource_size(b) && offset_b < offset_a + d.graph.resource_size(a);
+            bool same_time = !((a == d.albedo || a == d.normal || a == d.depth || a == d.shadow) && b == d.bloom);
+            if (same_time) {
+                EXPECT_FALSE(overlap) << d.graph.resource_name(a) << " " << d.graph.resource_name(b);
+            }
+        }
+    }
+
+    // The gbuffer is dead once bloom runs, so bloom reuses its memory.
+    auto bloom_offset = d.graph.heap_offset(d.bloom);
+    bool reused = false;
+    for (auto r : { d.albedo, d.normal, d.depth, d.shadow })
+        reused = reused || (bloom_offset < d.graph.heap_offset(r) + d.graph.resource_size(r) && d.graph.heap_offset(r) < bloom_offset + d.graph.resource_size(d.bloom));
+    EXPECT_TRUE(reused);
+}
+
+TEST(frame_graph, passes_sharing_aliased_memory_are_ordered)
+{
+    sigma::graphics::frame_graph graph;
+    auto left = graph.import("left");
+    auto right = graph.import("right");
+    sigma::graphics::frame_graph::resource_handle x, y;
+    auto write_x = graph.add_pass("write_x", [&](auto& b) { x = b.create_buffer("x", 1024); }, {});
+    auto read_x = graph.add_pass("read_x", [&](auto& b) { b.read(x); b.write(left); }, {});
+    auto write_y = graph.add_pass("write_y", [&](auto& b) { y = b.create_buffer("y", 1024); }, {});
+    auto read_y = graph.add_pass("read_y", [&](auto& b) { b.read(y); b.write(right); }, {});
+    graph.compile();
+
+    // Nothing connects the two chains except the heap memory x and y share.
+    ASSERT_EQ(graph.heap_offset(x), graph.heap_offset(y));
+    EXPECT_EQ(sigma::graphics::frame_graph::ALIGNMENT, graph.heap_size());
+
+    auto deps = graph.dependencies(write_y);
+    std::sort(deps.begin(), deps.end());
+    EXPECT_EQ((std::vector<sigma::graphics::frame_graph::pass_handle> { write_x, read_x }), deps);
+    EXPECT_EQ(std::vector<sigma::graphics::frame_graph::pass_handle> { write_y }, graph.dependencies(read_y));
+}
@@ -0,0 +1,94 @@
+#include <sigma/graphics/frame_packet.hpp>
+
+#include <sigma/graphics/static_mesh_instance.hpp>
+#include <sigma/transform.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(frame_packet, extract_copies_render_components)
+{
+    entt::registry<> registry;
+    auto mesh = registry.create();
+    auto lamp = registry.create();
+    auto sun = registry.create();
+    auto hidden = registry.create();
+    registry.assign<sigma::transform>(mesh).matrix = sigma::affine::compose({ 1, 2, 3 }, {}, glm::vec3 { 1 });
+    registry.assign<sigma::graphics::static_mesh_instance>(mesh, sigma::resource::handle_type<sigma::graphics::static_mesh> {});
+    registry.assign<sigma::transform>(lamp).matrix = sigma::affine::compose({ 4, 5, 6 }, {}, glm::vec3 { 1 });
+    registry.assign<sigma::graphics::point_light>(lamp, glm::vec3 { 1, 0, 0 }, 2.0f);
+    registry.assign<sigma::graphics::directional_light>(sun);
+    registry.assign<sigma::transform>(hidden);
+
+    sigma::graphics::frame_packet packet;
+    sigma::graphics::extract(registry, { { 640, 480 }, {} }, 7, packet);
+
+    EXPECT_EQ(7u, packet.frame);
+    EXPECT_EQ(glm::ivec2(640, 480), packet.view.size);
+    ASSERT_EQ(1u, packet.meshes.size());
+    EXPECT_EQ(mesh, packet.meshes[0].entity);
+    EXPECT_EQ(glm::vec3(1, 2, 3), sigma::affine::translation(packet.meshes[0].model));
+    ASSERT_EQ(1u, packet.point_lights.size());
+    EXPECT_EQ(glm::vec3(4, 5, 6), packet.point_lights[0].position);
+    EXPECT_EQ(2.0f, packet.point_lights[0].light.intensity);
+    EXPECT_EQ(1u, packet.directional_lights.size());
+    EXPECT_TRUE(packet.spot_lights.empty());
+
+    // The packet is a copy, later changes to the registry do not reach it.
+    registry.get<sigma::graphics::point_light>(lamp).intensity = 5.0f;
+    EXPECT_EQ(2.0f, packet.point_lights[0].light.intensity);
+}
+
+TEST(frame_packet, extract_changes_only_holds_changed_entities)
+{
+    entt::registry<> registry;
+    std::vector<entt::registry<>::entity_type> entities;
+    for (int i = 0; i < 10; ++i) {
+        auto e = registry.create();
+        registry.assign<sigma::transform>(e).matrix = sigma::affine::compose({ float(i), 0, 0 }, {}, glm::vec3 { 1 });
+        registry.assign<sigma::graphics::static_mesh_instance>(e, sigma::resource::handle_type<sigma::graphics::static_mesh> {});
+        entities.push_back(e);
+    }
+
+    sigma::graphics::frame_packet packet;
+    sigma::graphics::render_mirror mirror;
+    sigma::graphics::extract(registry, {}, 0, packet);
+    mirror.apply(packet);
+    ASSERT_EQ(10u, mirror.scene().meshes.size());
+
+    // Nothing changed.
+    sigma::graphics::extract_changes(registry, {}, 1, {}, {}, packet);
+    EXPECT_TRUE(packet.incremental);
+    EXPECT_TRUE(packet.meshes.empty());
+    mirror.apply(packet);
+    EXPECT_EQ(10u, mirror.scene().meshes.size());
+
+    // One moved, one gained a light, one was destroyed.
+    registry.get<sigma::transform>(entities[2]).matrix = sigma::affine::compose({ 20, 0, 0 }, {}, glm::vec3 { 1 });
+    registry.assign<sigma::graphics::point_light>(entities[5]);
+    registry.assign<sigma::graphics::render_changed>(entities[5]);
+    registry.destroy(entities[7]);
+    sigma::graphics::extract_changes(registry, {}, 2, { entities[2] }, { entities[7] }, packet);
+    EXPECT_EQ(2u, packet.meshes.size());
+    EXPECT_EQ(1u, packet.point_lights.size());
+    EXPECT_EQ(0u, registry.view<sigma::graphics::render_changed>().size());
+
+    mirror.apply(packet);
+    const auto& scene = mirror.scene();
+    EXPECT_EQ(2u, scene.frame);
+    ASSERT_EQ(9u, scene.meshes.size());
+    EXPECT_EQ(1u, scene.point_lights.size());
+    for (const auto& m : scene.meshes) {
+        EXPECT_NE(entities[7], m.entity);
+        if (m.entity == entities[2]) {
+            EXPECT_EQ(20.0f, sigma::affine::translation(m.model).x);
+        }
+    }
+
+    // Components taken off a tagged entity leave the mirror.
+    registry.remove<sigma::graphics::static_mesh_instance>(entities[5]);
+    registry.assign<sigma::graphics::render_changed>(entities[5]);
+    sigma::graphics::extract_changes(registry, {}, 3, {}, {}, packet);
+    mirror.apply(packet);
+    EXPECT_EQ(8u, mirror.scene().meshes.size());
+    EXPECT_EQ(1u, mirror.scene().point_lights.size());
+}
@@ -0,0 +1,144 @@
+#include <sigma/graphics/light_grid.hpp>
+#include <sigma/util/parallel.hpp>
+
+#include <gtest/gtest.h>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <random>
+
+namespace {
+sigma::frustum make_view()
+{
+    return { glm::radians(90.0f), 1.0f, 0.1f, 100.0f, glm::mat4(1) };
+}
+
+bool has_light(const sigma::graphics::light_grid& grid, std::size_t cluster, std::uint32_t first, std::uint32_t count, std::uint32_t light)
+{
+    const auto& c = grid.clusters()[cluster];
+    auto begin = grid.indices().begin() + c.offset + first;
+    return std::find(begin, begin + count, light) != begin + count;
+}
+
+bool has_point_light(const sigma::graphics::light_grid& grid, std::size_t cluster, std::uint32_t light)
+{
+    return has_light(grid, cluster, 0, grid.clusters()[cluster].point_count, light);
+}
+
+bool has_spot_light(const sigma::graphics::light_grid& grid, std::size_t cluster, std::uint32_t light)
+{
+    const auto& c = grid.clusters()[cluster];
+    return has_light(grid, cluster, c.point_count, c.spot_count, light);
+}
+}
+
+TEST(light_grid, point_light_is_assigned_to_every_cluster_it_reaches)
+{
+    std::mt19937 random { 7 };
+    std::uniform_real_distribution<float> coordinate { -20.0f, 20.0f };
+    std::uniform_real_distribution<float> depth { 0.5f, 60.0f };
+    std::uniform_real_distribution<float> range { 0.5f, 8.0f };
+
+    std::vector<sigma::graphics::frame_packet::point_light_instance> lights;
+    for (int i = 0; i < 200; ++i)
+        lights.push_back({ {}, { coordinate(random), coordinate(random), -depth(random) }, { { 1, 1, 1 }, 1.0f, range(random) } });
+
+    sigma::frame_allocator frames { 1 << 16, sigma::util::worker_count() };
+    sigma::graphics::light_grid grid;
+    grid.build(frames, make_view(), lights, {});
+
+    for (int i = 0; i < 2000; ++i) {
+        const float z = -depth(random);
+        const glm::vec3 p { coordinate(random) * -z / 20.0f, coordinate(random) * -z / 20.0f, z };
+        const std::size_t cluster = grid.cluster_at(p);
+        for (std::uint32_t l = 0; l < lights.size(); ++l) {
+            if (glm::distance(p, lights[l].position) < lights[l].light.range) {
+                EXPECT_TRUE(has_point_light(grid, cluster, l));
+            }
+        }
+    }
+}
+
+TEST(light_grid, point_light_is_not_assigned_to_clusters_out_of_range)
+{
+    std::vector<sigma::graphics::frame_packet::point_light_instance> lights;
+    lights.push_back({ {}, { 0, 0, -10 }, { { 1, 1, 1 }, 1.0f, 1.0f } });
+
+    sigma::frame_allocator frames { 1 << 16, sigma::util::worker_count() };
+    sigma::graphics::light_grid grid;
+    grid.build(frames, make_view(), lights, {});
+
+    EXPECT_TRUE(has_point_light(grid, grid.cluster_at({ 0, 0, -10 }), 0));
+    EXPECT_FALSE(has_point_light(grid, grid.cluster_at({ 0, 0, -50 }), 0));
+    EXPECT_FALSE(has_point_light(grid, grid.cluster_at({ 0, 0, -1 }), 0));
+    EXPECT_FALSE(has_point_light(grid, grid.cluster_at({ 8, 8, -10 }), 0));
+}
+
+TEST(light_grid, spot_light_is_assigned_to_clusters_inside_its_cone)
+{
+    std::vector<sigma::graphics::frame_packet::spot_light_instance> lights;
+    sigma::graphics::spot_light light { { 1, 1, 1 }, 1.0f, glm::radians(20.0f) };
+    light.direction = { 0, 0, -1 };
+    light.range = 30.0f;
+    lights.push_back({ {}, { 0, 0, -5 }, light });
+
+    sigma::frame_allocator frames { 1 << 16, sigma::util::worker_count() };
+    sigma::graphics::light_grid grid;
+    grid.build(frames, make_view(), {}, lights);
+
+    EXPECT_TRUE(has_spot_light(grid, grid.cluster_at({ 0, 0, -20 }), 0));
+    EXPECT_TRUE(has_spot_light(grid, grid.cluster_at({ 2, 2, -20 }), 0));
+    EXPECT_FALSE(has_spot_light(grid, grid.cluster_at({ 0, 0, -2 }), 0));
+    EXPECT_FALSE(has_spot_light(grid, grid.cluster_at({ 15, 0, -20 }), 0));
+    EXPECT_FALSE(has_spot_light(grid, grid.cluster_at({ 0, 0, -60 }), 0));
+}
+
+TEST(light_grid, cluster_lists_are_compact)
+{
+    std::vector<sigma::graphics::frame_packet::point_light_instance> points;
+    std::vector<sigma::graphics::frame_packet::spot_light_instance> spots;
+    for (int i = 0; i < 16; ++i) {
+        points.push_back({ {}, { i - 8.0f, 0, -5.0f - i }, { { 1, 1, 1 }, 1.0f, 3.0f } });
+        sigma::graphics::spot_light light;
+        light.direction = { 0, 0, -1 };
+        spots.push_back({ {}, { 0, i - 8.0f, -2.0f * i }, light });
+    }
+
+    sigma::frame_allocator frames { 1 << 16, sigma::util::worker_count() };
+    sigma::graphics::light_grid grid { { 7, 5, 11 } };
+    grid.build(frames, make_view(), points, spots);
+
+    ASSERT_EQ(7u * 5u * 11u, grid.clusters().size());
+    std::uint32_t offset = 0;
+    for (const auto& cluster : grid.clusters()) {
+        EXPECT_EQ(offset, cluster.offset);
+        for (std::uint32_t i = 0; i < cluster.point_count; ++i)
+            EXPECT_LT(grid.indices()[cluster.offset + i], points.size());
+        for (std::uint32_t i = 0; i < cluster.spot_count; ++i)
+            EXPECT_LT(grid.indices()[cluster.offset + cluster.point_count + i], spots.size());
+        offset += cluster.point_count + cluster.spot_count;
+    }
+    EXPECT_EQ(offset, grid.indices().size());
+    EXPECT_GT(offset, 0u);
+}
+
+TEST(light_grid, rebuilding_in_later_frames_gives_the_same_lists)
+{
+    std::vector<sigma::graphics::frame_packet::point_light_instance> lights;
+    for (int i = 0; i < 32; ++i)
+        lights.push_back({ {}, { i - 16.0f, 0, -4.0f - i }, { { 1, 1, 1 }, 1.0f, 4.0f } });
+
+    sigma::frame_allocator frames { 1 << 10, sigma::util::worker_count() };
+    sigma::graphics::light_grid grid;
+    grid.build(frames, make_view(), lights, {});
+    const std::vector<std::uint32_t> expected { grid.indices().begin(), grid.indices().end() };
+
+    for (std::size_t frame = 0; frame < 2 * sigma::frame_allocator::FRAME_COUNT; ++frame) {
+        frames.begin_frame();
+        grid.build(frames, make_view(), lights, {});
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), grid.indices().begin(), grid.indices().end()));
+    }
+}
@@ -0,0 +1,135 @@
+#include <sigma/graphics/mesh_bvh.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+// Random triangle soup in a 20 unit cube.
+sigma::graphics::static_mesh make_soup(std::size_t triangle_count)
+{
+    std::mt19937 rng { 17 };
+    std::uniform_real_distribution<float> position { -10.0f, 10.0f };
+    std::uniform_real_distribution<float> offset { -1.0f, 1.0f };
+
+    sigma::graphics::static_mesh mesh { {}, "soup" };
+    for (std::size_t i = 0; i < triangle_count; ++i) {
+        glm::vec3 center { position(rng), position(rng), position(rng) };
+        auto first = static_cast<unsigned int>(mesh.vertices().size());
+        for (int corner = 0; corner < 3; ++corner) {
+            sigma::graphics::static_mesh::vertex v;
+            v.position = center + glm::vec3 { offset(rng), offset(rng), offset(rng) };
+            mesh.vertices().push_back(v);
+        }
+        mesh.triangles().push_back({ first, first + 1, first + 2 });
+    }
+    return mesh;
+}
+
+float brute_force_distance(const sigma::graphics::static_mesh& mesh, const glm::vec3& origin, const glm::vec3& direction)
+{
+    // A bvh over a single triangle at a time runs the same intersection
+    // code without the traversal.
+    float closest = std::numeric_limits<float>::max();
+    for (const auto& tri : mesh.triangles()) {
+        sigma::graphics::static_mesh single { {}, "single" };
+        for (auto index : tri)
+            single.vertices().push_back(mesh.vertices()[index]);
+        single.triangles().push_back({ 0, 1, 2 });
+
+        sigma::graphics::mesh_bvh tree { {}, "single" };
+        tree.build(single);
+        sigma::graphics::mesh_bvh::hit hit;
+        if (tree.closest_hit(origin, direction, closest, hit))
+            closest = hit.distance;
+    }
+    return closest;
+}
+
+std::vector<std::pair<glm::vec3, glm::vec3>> random_rays(std::size_t count)
+{
+    std::mt19937 rng { 23 };
+    std::uniform_real_distribution<float> coordinate { -12.0f, 12.0f };
+    std::vector<std::pair<glm::vec3, glm::vec3>> rays;
+    for (std::size_t i = 0; i < count; ++i) {
+        glm::vec3 origin { coordinate(rng), coordinate(rng), -15.0f };
+        glm::vec3 target { coordinate(rng) * 0.5f, coordinate(rng) * 0.5f, 15.0f };
+        rays.push_back({ origin, glm::normalize(target - origin) });
+    }
+    return rays;
+}
+}
+
+TEST(mesh_bvh, closest_hit_matches_brute_force)
+{
+    auto mesh = make_soup(400);
+    sigma::graphics::mesh_bvh tree { {}, "soup" };
+    tree.build(mesh);
+    EXPECT_EQ(400u, tree.size());
+
+    int hit_count = 0;
+    for (const auto& ray : random_rays(64)) {
+        float expected = brute_force_distance(mesh, ray.first, ray.second);
+        sigma::graphics::mesh_bvh::hit hit;
+        bool found = tree.closest_hit(ray.first, ray.second, std::numeric_limits<float>::max(), hit);
+
+        EXPECT_EQ(expected != std::numeric_limits<float>::max(), found);
+        if (found) {
+            EXPECT_FLOAT_EQ(expected, hit.distance);
+        }
+        EXPECT_EQ(found, tree.any_hit(ray.first, ray.second, std::numeric_limits<float>::max()));
+        hit_count += found;
+    }
+    EXPECT_GT(hit_count, 0);
+}
+
+TEST(mesh_bvh, any_hit_respects_max_distance)
+{
+    sigma::graphics::static_mesh mesh { {}, "quad" };
+    for (auto p : { glm::vec3 { -1, -1, 5 }, glm::vec3 { 1, -1, 5 }, glm::vec3 { 0, 1, 5 } }) {
+        sigma::graphics::static_mesh::vertex v;
+        v.position = p;
+        mesh.vertices().push_back(v);
+    }
+    mesh.triangles().push_back({ 0, 1, 2 });
+
+    sigma::graphics::mesh_bvh tree { {}, "quad" };
+    tree.build(mesh);
+
+    EXPECT_TRUE(tree.any_hit({ 0, 0, 0 }, { 0, 0, 1 }, 10.0f));
+    EXPECT_FALSE(tree.any_hit({ 0, 0, 0 }, { 0, 0, 1 }, 4.0f));
+
+    sigma::graphics::mesh_bvh::hit hit;
+    ASSERT_TRUE(tree.closest_hit({ 0, 0, 0 }, { 0, 0, 1 }, 10.0f, hit));
+    EXPECT_FLOAT_EQ(5.0f, hit.distance);
+    EXPECT_EQ(0u, hit.triangle);
+}
+
+TEST(mesh_bvh, packets_match_single_rays)
+{
+    auto mesh = make_soup(2000);
+    sigma::graphics::mesh_bvh tree { {}, "soup" };
+    tree.build(mesh);
+
+    auto rays = random_rays(64);
+    for (std::size_t first = 0; first < rays.size(); first += 8) {
+        sigma::graphics::mesh_bvh::ray_packet<8> packet;
+        for (std::size_t i = 0; i < 8; ++i) {
+            packet.origin[i] = rays[first + i].first;
+            packet.direction[i] = rays[first + i].second;
+            packet.max_distance[i] = std::numeric_limits<float>::max();
+        }
+
+        std::array<sigma::graphics::mesh_bvh::hit, 8> hits;
+        std::uint64_t closest = tree.closest_hit(packet, hits);
+        std::uint64_t any = tree.any_hit(packet);
+        EXPECT_EQ(closest, any);
+
+        for (std::size_t i = 0; i < 8; ++i) {
+            sigma::graphics::mesh_bvh::hit expected;
+            bool found = tree.closest_hit(packet.origin[i], packet.direction[i], packet.max_distance[i], expected);
+            EXPECT_EQ(found, (closest >> i) & 1);
+            EXPECT_EQ(expected.triangle, hits[i].triangle);
+        }
+    }
+}
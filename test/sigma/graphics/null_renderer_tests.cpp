@@ -0,0 +1,104 @@
+#include <sigma/graphics/null_renderer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace {
+std::shared_ptr<sigma::context> make_context()
+{
+    return std::make_shared<sigma::context>(".");
+}
+
+void record_scene(sigma::graphics::render_queue* queue, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        auto cmd = queue->enqueue(sigma::graphics::make_sort_key(0, 1, i % 2, i % 2, 0.5f));
+        cmd->program = 1;
+        cmd->mesh = i % 2;
+        cmd->count = 36;
+        cmd->input_textures[0] = i % 2;
+        cmd->model = sigma::affine::compose({ float(i), 0, 0 }, {}, glm::vec3 { 1 });
+    }
+}
+}
+
+TEST(null_renderer, render_records_batched_state_changes)
+{
+    sigma::graphics::null_renderer renderer { { 640, 480 }, make_context() };
+    record_scene(renderer.queue(), 10);
+
+    renderer.render();
+
+    EXPECT_EQ(1u, renderer.frame_count());
+    EXPECT_EQ(2u, renderer.stats().draws);
+    EXPECT_TRUE(renderer.queue()->empty());
+    EXPECT_EQ(renderer.stats().binds + renderer.stats().draws, renderer.recorded().size());
+    EXPECT_EQ(sigma::graphics::state_op::draw, renderer.recorded().back().op);
+}
+
+TEST(null_renderer, render_packs_draw_blocks_and_instances)
+{
+    sigma::graphics::null_renderer renderer { { 640, 480 }, make_context() };
+    record_scene(renderer.queue(), 10);
+
+    renderer.render();
+
+    const auto& uniforms = renderer.uniforms();
+    ASSERT_EQ(2 * sizeof(sigma::graphics::null_renderer::draw_block) + 10 * sizeof(sigma::affine::matrix), uniforms.size());
+
+    sigma::graphics::null_renderer::draw_block second;
+    std::memcpy(&second, uniforms.data() + sizeof(second), sizeof(second));
+    EXPECT_EQ(5u, second.instance_offset);
+    EXPECT_EQ(5u, second.instance_count);
+}
+
+TEST(null_renderer, timings_cover_every_stage)
+{
+    sigma::graphics::null_renderer renderer { { 640, 480 }, make_context() };
+    record_scene(renderer.queue(), 1000);
+
+    renderer.render();
+
+    const auto& t = renderer.timings();
+    EXPECT_GE(t.total, t.sort + t.batch + t.state + t.pack + t.submit);
+}
+
+TEST(null_renderer, views_are_packed_once_at_aligned_offsets)
+{
+    sigma::graphics::null_renderer renderer { { 640, 480 }, make_context() };
+    sigma::frustum camera { 1.0f, 4.0f / 3.0f, 0.1f, 100.0f };
+    sigma::frustum shadow { -10, 10, -10, 10, 0.1f, 50.0f };
+    renderer.queue()->add_view(sigma::graphics::make_standard_block(camera, { 640, 480 }, 1.0f));
+    renderer.queue()->add_view(sigma::graphics::make_standard_block(shadow, { 2048, 2048 }, 1.0f));
+    record_scene(renderer.queue(), 10);
+
+    renderer.render();
+
+    EXPECT_EQ(512u, renderer.view_stride());
+    ASSERT_EQ(2 * renderer.view_stride(), renderer.view_uniforms().size());
+    glm::mat4 projection_view;
+    std::memcpy(&projection_view, renderer.view_uniforms().data() + renderer.view_stride() + 256, sizeof(projection_view));
+    EXPECT_EQ(shadow.projection_view(), projection_view);
+    glm::vec2 size;
+    std::memcpy(&size, renderer.view_uniforms().data() + renderer.view_stride() + 384, sizeof(size));
+    EXPECT_EQ(glm::vec2(2048, 2048), size);
+}
+
+TEST(null_renderer, render_leaves_frame_advance_to_its_owner)
+{
+    auto ctx = make_context();
+    sigma::graphics::null_renderer first { { 640, 480 }, ctx };
+    sigma::graphics::null_renderer second { { 640, 480 }, ctx };
+    record_scene(first.queue(), 10);
+    record_scene(second.queue(), 10);
+
+    ctx->render_memory().begin_frame();
+    first.render();
+    second.render();
+
+    EXPECT_EQ(1u, ctx->render_memory().frame());
+    EXPECT_EQ(0u, ctx->frame_memory().frame());
+    EXPECT_EQ(first.uniforms().size(), second.uniforms().size());
+    EXPECT_EQ(0, std::memcmp(first.uniforms().data(), second.uniforms().data(), first.uniforms().size()));
+}
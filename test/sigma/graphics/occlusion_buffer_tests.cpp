@@ -0,0 +1,62 @@
+#include <sigma/graphics/occlusion_buffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+namespace {
+// A 10x10 wall facing the camera 10 units in front of it.
+sigma::graphics::occlusion_buffer make_buffer_with_wall()
+{
+    sigma::graphics::occlusion_buffer buffer { { 128, 128 } };
+    buffer.begin(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f));
+
+    std::vector<glm::vec3> positions = { { -5, -5, -10 }, { 5, -5, -10 }, { 5, 5, -10 }, { -5, 5, -10 } };
+    std::vector<sigma::graphics::static_mesh::triangle> triangles = { { 0, 1, 2 }, { 0, 2, 3 } };
+    buffer.add_occluder(positions, triangles, glm::mat4(1));
+    buffer.render();
+    return buffer;
+}
+}
+
+TEST(occlusion_buffer, box_behind_occluder_is_not_visible)
+{
+    auto buffer = make_buffer_with_wall();
+
+    EXPECT_FALSE(buffer.is_visible(sigma::AABB { { 0, 0, -20 }, { 2, 2, 2 } }));
+}
+
+TEST(occlusion_buffer, box_in_front_of_occluder_is_visible)
+{
+    auto buffer = make_buffer_with_wall();
+
+    EXPECT_TRUE(buffer.is_visible(sigma::AABB { { 0, 0, -5 }, { 2, 2, 2 } }));
+}
+
+TEST(occlusion_buffer, box_beside_occluder_is_visible)
+{
+    auto buffer = make_buffer_with_wall();
+
+    EXPECT_TRUE(buffer.is_visible(sigma::AABB { { 25, 0, -30 }, { 2, 2, 2 } }));
+}
+
+TEST(occlusion_buffer, box_crossing_near_plane_is_visible)
+{
+    auto buffer = make_buffer_with_wall();
+
+    EXPECT_TRUE(buffer.is_visible(sigma::AABB { { 0, 0, 0 }, { 2, 2, 2 } }));
+}
+
+TEST(occlusion_buffer, back_facing_occluders_are_ignored)
+{
+    sigma::graphics::occlusion_buffer buffer { { 64, 64 } };
+    buffer.begin(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f));
+
+    std::vector<glm::vec3> positions = { { -5, -5, -10 }, { 5, -5, -10 }, { 5, 5, -10 } };
+    std::vector<sigma::graphics::static_mesh::triangle> triangles = { { 0, 2, 1 } };
+    buffer.add_occluder(positions, triangles, glm::mat4(1));
+    buffer.render();
+
+    EXPECT_EQ(1.0f, buffer.depth(buffer.level_count() - 1, { 0, 0 }));
+}
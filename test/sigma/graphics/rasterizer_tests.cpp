@@ -0,0 +1,47 @@
+#include <sigma/graphics/rasterizer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+bool covers(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float x, float y)
+{
+    const sigma::graphics::rasterizer::edge e0 { v1, v2 };
+    const sigma::graphics::rasterizer::edge e1 { v2, v0 };
+    const sigma::graphics::rasterizer::edge e2 { v0, v1 };
+    return e0.covers(e0(x, y)) && e1.covers(e1(x, y)) && e2.covers(e2(x, y));
+}
+}
+
+TEST(rasterizer, shared_edges_are_drawn_once)
+{
+    // A square split along its diagonal with every edge on pixel centers.
+    const glm::vec3 a { 0.5f, 0.5f, 0 }, b { 4.5f, 0.5f, 0 }, c { 4.5f, 4.5f, 0 }, d { 0.5f, 4.5f, 0 };
+    ASSERT_TRUE(sigma::graphics::rasterizer::is_front_facing(a, b, c));
+    ASSERT_TRUE(sigma::graphics::rasterizer::is_front_facing(a, c, d));
+
+    int covered = 0;
+    for (int y = 0; y < 6; ++y) {
+        for (int x = 0; x < 6; ++x) {
+            const int count = covers(a, b, c, x + 0.5f, y + 0.5f) + covers(a, c, d, x + 0.5f, y + 0.5f);
+            EXPECT_LE(count, 1) << x << " " << y;
+            covered += count;
+        }
+    }
+    EXPECT_EQ(16, covered);
+
+    // Left and top edges are inside, right and bottom edges are not.
+    EXPECT_TRUE(covers(a, c, d, 0.5f, 2.5f));
+    EXPECT_TRUE(covers(a, c, d, 2.5f, 4.5f));
+    EXPECT_FALSE(covers(a, b, c, 4.5f, 2.5f));
+    EXPECT_FALSE(covers(a, b, c, 2.5f, 0.5f));
+}
+
+TEST(rasterizer, tile_range_clamps_to_the_screen)
+{
+    glm::ivec2 first, last;
+    ASSERT_TRUE(sigma::graphics::rasterizer::tile_range({ -10, -10, 0 }, { 40, -10, 0 }, { 40, 70, 0 }, { 64, 64 }, 32, { 2, 2 }, first, last));
+    EXPECT_EQ(glm::ivec2(0, 0), first);
+    EXPECT_EQ(glm::ivec2(1, 1), last);
+
+    EXPECT_FALSE(sigma::graphics::rasterizer::tile_range({ 70, 0, 0 }, { 80, 0, 0 }, { 80, 10, 0 }, { 64, 64 }, 32, { 2, 2 }, first, last));
+}
@@ -0,0 +1,89 @@
+#include <sigma/graphics/render_pipeline.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+TEST(render_pipeline, packets_are_rendered_in_submission_order)
+{
+    std::vector<std::uint64_t> rendered;
+    {
+        sigma::graphics::render_pipeline pipeline { [&](const sigma::graphics::frame_packet& packet) { rendered.push_back(packet.frame); } };
+        for (std::uint64_t frame = 0; frame < 100; ++frame) {
+            auto& packet = pipeline.begin_frame();
+            packet.frame = frame;
+            pipeline.submit();
+        }
+    }
+
+    ASSERT_EQ(100u, rendered.size());
+    for (std::uint64_t frame = 0; frame < 100; ++frame)
+        EXPECT_EQ(frame, rendered[frame]);
+}
+
+TEST(render_pipeline, game_runs_one_frame_ahead_of_rendering)
+{
+    std::atomic<bool> release { false };
+    sigma::graphics::render_pipeline pipeline { [&](const sigma::graphics::frame_packet&) {
+        while (!release)
+            std::this_thread::yield();
+    } };
+
+    pipeline.begin_frame().frame = 0;
+    pipeline.submit();
+    // Frame 0 is still rendering, frame 1 goes to the other packet.
+    auto& second = pipeline.begin_frame();
+    second.frame = 1;
+    pipeline.submit();
+    EXPECT_EQ(0u, pipeline.rendered_frames());
+    EXPECT_EQ(2u, pipeline.submitted_frames());
+
+    release = true;
+    pipeline.flush();
+    EXPECT_EQ(2u, pipeline.rendered_frames());
+}
+
+TEST(render_pipeline, packet_being_rendered_is_not_handed_out)
+{
+    std::atomic<int> rendering { -1 };
+    std::atomic<bool> overlap { false };
+    sigma::graphics::render_pipeline pipeline { [&](const sigma::graphics::frame_packet& packet) {
+        rendering = int(packet.frame % 2);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        rendering = -1;
+    } };
+
+    for (std::uint64_t frame = 0; frame < 20; ++frame) {
+        auto& packet = pipeline.begin_frame();
+        if (rendering == int(frame % 2))
+            overlap = true;
+        packet.frame = frame;
+        pipeline.submit();
+    }
+    pipeline.flush();
+
+    EXPECT_FALSE(overlap);
+}
+
+TEST(render_pipeline, frame_memory_advances_on_the_render_thread)
+{
+    sigma::frame_allocator frames;
+    std::vector<std::uint64_t> seen;
+    {
+        sigma::graphics::render_pipeline pipeline { [&](const sigma::graphics::frame_packet&) {
+            seen.push_back(frames.frame());
+            frames.allocate(64);
+        },
+            &frames };
+        for (int frame = 0; frame < 5; ++frame) {
+            pipeline.begin_frame();
+            pipeline.submit();
+        }
+    }
+
+    ASSERT_EQ(5u, seen.size());
+    for (std::uint64_t i = 0; i < seen.size(); ++i)
+        EXPECT_EQ(i + 1, seen[i]);
+}
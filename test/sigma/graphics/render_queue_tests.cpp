@@ -0,0 +1,133 @@
+#include <sigma/graphics/render_queue.hpp>
+#include <sigma/util/parallel.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+TEST(render_queue, radix_sort_matches_stable_sort)
+{
+    for (std::size_t count : { 10, 1000, 100000 }) {
+        std::mt19937_64 rng { count };
+        std::vector<sigma::graphics::render_queue::entry> entries;
+        for (std::size_t i = 0; i < count; ++i) {
+            // Few distinct high bits like real keys, with many duplicates
+            // to check that equal keys keep their order.
+            std::uint64_t key = sigma::graphics::make_sort_key(rng() % 3, rng() % 20, rng() % 50, rng() % 100, float(rng() % 8) / 8.0f);
+            entries.push_back({ key, static_cast<std::uint32_t>(i) });
+        }
+
+        auto expected = entries;
+        std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+
+        std::vector<sigma::graphics::render_queue::entry> scratch;
+        sigma::graphics::render_queue::radix_sort(entries, scratch);
+        ASSERT_EQ(expected.size(), entries.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(expected[i].key, entries[i].key);
+            EXPECT_EQ(expected[i].index, entries[i].index);
+        }
+    }
+}
+
+TEST(render_queue, sort_orders_entries_without_moving_commands)
+{
+    sigma::graphics::render_queue queue { 0 };
+    for (std::uint32_t i = 0; i < 1000; ++i)
+        queue.enqueue(sigma::graphics::make_sort_key(0, 999 - i, 0, 0, 0.0f))->program = i;
+
+    queue.sort();
+    for (std::uint32_t i = 0; i < queue.size(); ++i) {
+        EXPECT_EQ(i, queue.commands()[i].program);
+        EXPECT_EQ(999 - i, queue.command(queue.entries()[i]).program);
+    }
+}
+
+TEST(render_queue, sort_keys_order_by_pass_state_then_depth)
+{
+    using sigma::graphics::make_sort_key;
+    EXPECT_LT(make_sort_key(0, 100, 100, 100, 1.0f), make_sort_key(1, 0, 0, 0, 0.0f));
+    EXPECT_LT(make_sort_key(0, 1, 100, 100, 1.0f), make_sort_key(0, 2, 0, 0, 0.0f));
+    EXPECT_LT(make_sort_key(0, 1, 1, 1, 0.25f), make_sort_key(0, 1, 1, 1, 0.75f));
+
+    using sigma::graphics::make_blended_sort_key;
+    EXPECT_LT(make_blended_sort_key(2, 0.9f, 5, 5), make_blended_sort_key(2, 0.1f, 0, 0));
+    EXPECT_LT(make_sort_key(1, 4095, 65535, 65535, 1.0f), make_blended_sort_key(2, 1.0f, 0, 0));
+}
+
+TEST(render_queue, buckets_merge_in_bucket_order)
+{
+    sigma::graphics::render_queue queue { 0 };
+    queue.enqueue(0)->program = 1000;
+
+    queue.reserve_buckets(8);
+    sigma::util::parallel_for(8 * 100, 100, [&](std::size_t begin, std::size_t end) {
+        auto& bucket = queue.bucket(begin / 100);
+        for (std::size_t i = begin; i < end; ++i)
+            bucket.enqueue(i)->program = i;
+    });
+    queue.merge();
+
+    ASSERT_EQ(801u, queue.size());
+    EXPECT_EQ(1000u, queue.commands()[0].program);
+    for (std::uint32_t i = 1; i < queue.size(); ++i) {
+        EXPECT_EQ(i - 1, queue.commands()[i].program);
+        EXPECT_EQ(i - 1, queue.entries()[i].key);
+        EXPECT_EQ(i, queue.entries()[i].index);
+    }
+    for (std::size_t i = 0; i < queue.bucket_count(); ++i)
+        EXPECT_EQ(0u, queue.bucket(i).size());
+}
+
+TEST(render_queue, build_batches_merges_identical_draws)
+{
+    sigma::graphics::render_queue queue { 0 };
+    for (int i = 0; i < 6; ++i) {
+        auto cmd = queue.enqueue(sigma::graphics::make_sort_key(0, 1, 1, i < 4 ? 1 : 2, i / 10.0f));
+        cmd->program = 1;
+        cmd->mesh = i < 4 ? 1 : 2;
+        cmd->count = 36;
+        cmd->model = sigma::affine::compose({ float(i), 0, 0 }, {}, glm::vec3 { 1 });
+    }
+    // Same mesh but a different texture can not join the first batch.
+    auto other = queue.enqueue(sigma::graphics::make_sort_key(0, 1, 1, 1, 1.0f));
+    other->program = 1;
+    other->mesh = 1;
+    other->count = 36;
+    other->input_textures[0] = 7;
+
+    queue.sort();
+    queue.build_batches();
+
+    ASSERT_EQ(3u, queue.batches().size());
+    EXPECT_EQ(4u, queue.batches()[0].instance_count);
+    EXPECT_EQ(1u, queue.batches()[1].instance_count);
+    EXPECT_EQ(2u, queue.batches()[2].instance_count);
+    ASSERT_EQ(7u, queue.instances().size());
+    for (const auto& batch : queue.batches()) {
+        for (std::uint32_t i = 0; i < batch.instance_count; ++i) {
+            const auto& cmd = queue.command(queue.entries()[batch.first + i]);
+            EXPECT_EQ(sigma::affine::translation(cmd.model), sigma::affine::translation(queue.instances()[batch.instance_offset + i]));
+        }
+    }
+}
+
+TEST(render_queue, build_batches_keeps_views_apart)
+{
+    sigma::graphics::render_queue queue { 0 };
+    for (int i = 0; i < 4; ++i) {
+        auto cmd = queue.enqueue(sigma::graphics::make_sort_key(0, 1, 1, 1, i / 10.0f));
+        cmd->program = 1;
+        cmd->mesh = 1;
+        cmd->count = 36;
+        cmd->view = i < 2 ? 0 : 1;
+    }
+
+    queue.sort();
+    queue.build_batches();
+
+    ASSERT_EQ(2u, queue.batches().size());
+    EXPECT_EQ(2u, queue.batches()[0].instance_count);
+    EXPECT_EQ(2u, queue.batches()[1].instance_count);
+}
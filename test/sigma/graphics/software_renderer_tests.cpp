@@ -0,0 +1,125 @@
+#include <sigma/graphics/software_renderer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <cmath>
+
+namespace {
+std::shared_ptr<sigma::graphics::static_mesh> make_quad()
+{
+    auto mesh = std::make_shared<sigma::graphics::static_mesh>(std::weak_ptr<sigma::context> {}, "quad");
+    for (auto p : { glm::vec3 { -1, -1, 0 }, glm::vec3 { 1, -1, 0 }, glm::vec3 { 1, 1, 0 }, glm::vec3 { -1, 1, 0 } }) {
+        sigma::graphics::static_mesh::vertex v;
+        v.position = p;
+        v.normal = { 0, 0, 1 };
+        mesh->vertices().push_back(v);
+    }
+    mesh->triangles() = { { 0, 1, 2 }, { 0, 2, 3 } };
+    return mesh;
+}
+
+sigma::graphics::standard_block make_view()
+{
+    return sigma::graphics::make_standard_block(sigma::frustum { glm::radians(90.0f), 1.0f, 0.1f, 100.0f }, { 64, 64 }, 0.0f);
+}
+
+void draw_quad(sigma::graphics::software_renderer& renderer, float z, std::uint64_t texture, const sigma::affine::matrix& rotation = sigma::affine::identity())
+{
+    auto cmd = renderer.queue()->enqueue();
+    cmd->mesh = 1;
+    cmd->input_textures[0] = texture;
+    cmd->model = sigma::affine::multiply(sigma::affine::compose({ 0, 0, z }, {}, glm::vec3 { 1 }), rotation);
+    cmd->view = renderer.queue()->views().empty() ? renderer.queue()->add_view(make_view()) : 0;
+}
+
+struct fixture {
+    sigma::graphics::software_renderer renderer { { 64, 64 }, std::make_shared<sigma::context>(".") };
+
+    fixture()
+    {
+        renderer.set_mesh(1, make_quad());
+        renderer.set_surface(1, { { 1, 0, 0 }, 0.25f });
+        renderer.set_surface(2, { { 0, 0, 1 }, 0.75f });
+    }
+};
+}
+
+TEST(software_renderer, quad_fills_the_gbuffer)
+{
+    fixture f;
+    draw_quad(f.renderer, -2, 1);
+    f.renderer.render();
+
+    const auto& g = f.renderer.output();
+    auto center = g.index({ 32, 32 });
+    EXPECT_EQ(glm::vec3(1, 0, 0), g.albedo[center]);
+    EXPECT_EQ(0.25f, g.roughness[center]);
+    EXPECT_NEAR(1.0f, g.normal[center].z, 1e-5f);
+    EXPECT_LT(g.depth[center], 1.0f);
+
+    // The quad covers the middle half of the screen.
+    EXPECT_EQ(1.0f, g.depth[g.index({ 4, 4 })]);
+    EXPECT_EQ(1.0f, g.depth[g.index({ 60, 32 })]);
+    EXPECT_LT(g.depth[g.index({ 17, 17 })], 1.0f);
+    EXPECT_TRUE(f.renderer.queue()->empty());
+}
+
+TEST(software_renderer, nearest_surface_wins_whatever_the_order)
+{
+    fixture f;
+    draw_quad(f.renderer, -2, 1);
+    draw_quad(f.renderer, -4, 2);
+    f.renderer.render();
+    EXPECT_EQ(glm::vec3(1, 0, 0), f.renderer.output().albedo[f.renderer.output().index({ 32, 32 })]);
+
+    draw_quad(f.renderer, -4, 2);
+    draw_quad(f.renderer, -2, 1);
+    f.renderer.render();
+    EXPECT_EQ(glm::vec3(1, 0, 0), f.renderer.output().albedo[f.renderer.output().index({ 32, 32 })]);
+}
+
+TEST(software_renderer, normals_follow_the_model_rotation)
+{
+    fixture f;
+    draw_quad(f.renderer, -3, 1, sigma::affine::compose({}, glm::angleAxis(glm::radians(30.0f), glm::vec3 { 0, 1, 0 }), glm::vec3 { 1, 2, 1 }));
+    f.renderer.render();
+
+    const auto& g = f.renderer.output();
+    auto n = g.normal[g.index({ 32, 32 })];
+    EXPECT_NEAR(std::sin(glm::radians(30.0f)), n.x, 1e-4f);
+    EXPECT_NEAR(0.0f, n.y, 1e-4f);
+    EXPECT_NEAR(std::cos(glm::radians(30.0f)), n.z, 1e-4f);
+}
+
+TEST(software_renderer, back_faces_are_culled)
+{
+    fixture f;
+    draw_quad(f.renderer, -2, 1, sigma::affine::compose({}, glm::angleAxis(glm::radians(180.0f), glm::vec3 { 0, 1, 0 }), glm::vec3 { 1 }));
+    f.renderer.render();
+
+    EXPECT_EQ(1.0f, f.renderer.output().depth[f.renderer.output().index({ 32, 32 })]);
+}
+
+TEST(software_renderer, triangles_crossing_the_near_plane_are_clipped)
+{
+    fixture f;
+    // A floor below the eye reaching from behind it to z = -10.
+    auto cmd = f.renderer.queue()->enqueue();
+    cmd->mesh = 1;
+    cmd->input_textures[0] = 1;
+    cmd->model = sigma::affine::compose({ 0, -1, 0 }, glm::angleAxis(glm::radians(-90.0f), glm::vec3 { 1, 0, 0 }), glm::vec3 { 10 });
+    cmd->view = f.renderer.queue()->add_view(make_view());
+    f.renderer.render();
+
+    const auto& g = f.renderer.output();
+    auto below = g.index({ 32, 4 });
+    EXPECT_LT(g.depth[below], 1.0f);
+    EXPECT_GE(g.depth[below], 0.0f);
+    EXPECT_EQ(glm::vec3(1, 0, 0), g.albedo[below]);
+    EXPECT_NEAR(1.0f, g.normal[below].y, 1e-4f);
+    EXPECT_LT(g.depth[g.index({ 0, 0 })], 1.0f);
+    EXPECT_EQ(1.0f, g.depth[g.index({ 32, 40 })]);
+}
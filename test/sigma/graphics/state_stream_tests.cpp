@@ -0,0 +1,84 @@
+#include <sigma/graphics/state_stream.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+sigma::graphics::render_command* add_draw(sigma::graphics::render_queue& queue, std::uint64_t key, std::uint64_t program, std::uint64_t mesh, std::uint64_t texture)
+{
+    auto cmd = queue.enqueue(key);
+    cmd->program = program;
+    cmd->mesh = mesh;
+    cmd->count = 3;
+    cmd->input_textures[0] = texture;
+    return cmd;
+}
+}
+
+TEST(state_stream, first_draw_binds_every_slot)
+{
+    sigma::graphics::render_queue queue { 0 };
+    add_draw(queue, 0, 1, 1, 5);
+    queue.sort();
+    queue.build_batches();
+
+    sigma::graphics::state_stream stream;
+    stream.build(queue);
+
+    EXPECT_EQ(4u + MAX_BUFFER_BINDINGS + MAX_TEXTURE_BINDINGS, stream.stats().binds);
+    EXPECT_EQ(0u, stream.stats().eliminated_binds);
+    EXPECT_EQ(1u, stream.stats().draws);
+    EXPECT_EQ(sigma::graphics::state_op::draw, stream.changes().back().op);
+}
+
+TEST(state_stream, only_changed_state_is_bound_between_draws)
+{
+    sigma::graphics::render_queue queue { 0 };
+    add_draw(queue, 0, 1, 1, 5);
+    add_draw(queue, 1, 1, 2, 5);
+    add_draw(queue, 2, 1, 2, 6);
+    queue.sort();
+    queue.build_batches();
+
+    sigma::graphics::state_stream stream;
+    stream.build(queue);
+
+    const std::size_t slots = 4 + MAX_BUFFER_BINDINGS + MAX_TEXTURE_BINDINGS;
+    EXPECT_EQ(3u, stream.stats().draws);
+    EXPECT_EQ(slots + 2, stream.stats().binds);
+    EXPECT_EQ(2 * slots - 2, stream.stats().eliminated_binds);
+
+    const auto& changes = stream.changes();
+    ASSERT_EQ(slots + 2 + 3, changes.size());
+    EXPECT_EQ(sigma::graphics::state_op::bind_mesh, changes[slots + 1].op);
+    EXPECT_EQ(2u, changes[slots + 1].value);
+    EXPECT_EQ(sigma::graphics::state_op::draw, changes[slots + 2].op);
+    EXPECT_EQ(1u, changes[slots + 2].value);
+    EXPECT_EQ(sigma::graphics::state_op::bind_texture, changes[slots + 3].op);
+    EXPECT_EQ(0u, changes[slots + 3].slot);
+    EXPECT_EQ(6u, changes[slots + 3].value);
+}
+
+TEST(state_stream, group_changes_are_bound)
+{
+    sigma::graphics::render_queue queue { 0 };
+    add_draw(queue, 0, 1, 1, 5)->group = 7;
+    add_draw(queue, 1, 1, 1, 5)->group = 8;
+    queue.sort();
+    queue.build_batches();
+
+    sigma::graphics::state_stream stream;
+    stream.build(queue);
+
+    const std::size_t slots = 4 + MAX_BUFFER_BINDINGS + MAX_TEXTURE_BINDINGS;
+    EXPECT_EQ(2u, stream.stats().draws);
+    EXPECT_EQ(slots + 1, stream.stats().binds);
+
+    const auto& changes = stream.changes();
+    ASSERT_EQ(slots + 1 + 2, changes.size());
+    EXPECT_EQ(sigma::graphics::state_op::bind_group, changes[1].op);
+    EXPECT_EQ(7u, changes[1].value);
+    EXPECT_EQ(sigma::graphics::state_op::bind_group, changes[slots + 1].op);
+    EXPECT_EQ(8u, changes[slots + 1].value);
+    EXPECT_EQ(sigma::graphics::state_op::draw, changes.back().op);
+    EXPECT_EQ(1u, changes.back().value);
+}
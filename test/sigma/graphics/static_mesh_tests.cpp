@@ -0,0 +1,129 @@
+#include <sigma/graphics/static_mesh.hpp>
+
+#include <cereal/archives/binary.hpp>
+#include <gtest/gtest.h>
+
+#include <glm/geometric.hpp>
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+
+namespace {
+sigma::graphics::static_mesh make_mesh(const std::vector<glm::vec3>& positions)
+{
+    sigma::graphics::static_mesh mesh { {}, "mesh" };
+    for (const auto& p : positions) {
+        sigma::graphics::static_mesh::vertex v;
+        v.position = p;
+        mesh.vertices().push_back(v);
+    }
+    return mesh;
+}
+
+// AABB keeps a center and a size so the corners are only exact to rounding.
+void expect_near(const glm::vec3& expected, const glm::vec3& actual)
+{
+    EXPECT_NEAR(expected.x, actual.x, 1e-4f);
+    EXPECT_NEAR(expected.y, actual.y, 1e-4f);
+    EXPECT_NEAR(expected.z, actual.z, 1e-4f);
+}
+}
+
+TEST(static_mesh, compute_bounds_covers_every_vertex)
+{
+    std::mt19937 rng { 5 };
+    std::uniform_real_distribution<float> coordinate { -20.0f, 40.0f };
+    std::vector<glm::vec3> positions;
+    for (int i = 0; i < 50000; ++i)
+        positions.push_back({ coordinate(rng), coordinate(rng) * 0.5f, coordinate(rng) });
+
+    auto mesh = make_mesh(positions);
+    mesh.compute_bounds();
+
+    glm::vec3 min = positions[0];
+    glm::vec3 max = positions[0];
+    for (const auto& p : positions) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+        EXPECT_LE(glm::distance(p, mesh.sphere().center), mesh.sphere().radius * 1.0001f);
+    }
+    expect_near(min, mesh.bounds().min());
+    expect_near(max, mesh.bounds().max());
+}
+
+TEST(static_mesh, compute_bounds_fits_each_part)
+{
+    auto mesh = make_mesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 10, 10, 10 }, { 12, 10, 10 }, { 10, 12, 10 } });
+    mesh.triangles() = { { 0, 1, 2 }, { 3, 4, 5 } };
+    mesh.parts().emplace_back(0, 1, sigma::resource::handle_type<sigma::graphics::material> {});
+    mesh.parts().emplace_back(1, 2, sigma::resource::handle_type<sigma::graphics::material> {});
+    mesh.compute_bounds();
+
+    expect_near(glm::vec3(0, 0, 0), mesh.parts()[0].bounds().min());
+    expect_near(glm::vec3(1, 1, 0), mesh.parts()[0].bounds().max());
+    expect_near(glm::vec3(10, 10, 10), mesh.parts()[1].bounds().min());
+    expect_near(glm::vec3(12, 12, 10), mesh.parts()[1].bounds().max());
+    EXPECT_LE(mesh.parts()[1].sphere().radius, std::sqrt(2.0f) + 1e-4f);
+}
+
+TEST(static_mesh, compute_bounds_keeps_radius)
+{
+    auto mesh = make_mesh({ { -1, 0, 0 }, { 1, 2, 0 } });
+    mesh.set_radius(10.0f);
+    mesh.compute_bounds();
+    EXPECT_FLOAT_EQ(10.0f, mesh.radius());
+}
+
+TEST(static_mesh, save_and_load_keep_bounds_and_radius)
+{
+    // Parts are left out, saving one needs a material resource.
+    auto saved = make_mesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 10, 10, 10 }, { 12, 10, 10 }, { 10, 12, 10 } });
+    saved.triangles() = { { 0, 1, 2 }, { 3, 4, 5 } };
+    saved.compute_bounds();
+    saved.set_radius(42.0f);
+
+    std::stringstream stream;
+    {
+        cereal::BinaryOutputArchive ar { stream };
+        ar(saved);
+    }
+
+    sigma::graphics::static_mesh mesh { {}, "mesh" };
+    {
+        cereal::BinaryInputArchive ar { stream };
+        ar(mesh);
+    }
+
+    EXPECT_FLOAT_EQ(42.0f, mesh.radius());
+    expect_near(saved.bounds().min(), mesh.bounds().min());
+    expect_near(saved.bounds().max(), mesh.bounds().max());
+    expect_near(saved.sphere().center, mesh.sphere().center);
+    EXPECT_FLOAT_EQ(saved.sphere().radius, mesh.sphere().radius);
+}
+
+TEST(static_mesh, load_computes_bounds_for_version_1_streams)
+{
+    std::vector<sigma::graphics::static_mesh::vertex> vertices(2);
+    vertices[0].position = { -1, -2, -3 };
+    vertices[1].position = { 4, 5, 6 };
+    std::vector<sigma::graphics::static_mesh::triangle> triangles;
+    std::vector<sigma::graphics::mesh_part> parts;
+
+    std::stringstream stream;
+    {
+        cereal::BinaryOutputArchive ar { stream };
+        ar(std::uint32_t { 1 }, 3.0f, vertices, triangles, parts);
+    }
+
+    sigma::graphics::static_mesh mesh { {}, "mesh" };
+    {
+        cereal::BinaryInputArchive ar { stream };
+        ar(mesh);
+    }
+
+    ASSERT_EQ(2u, mesh.vertices().size());
+    EXPECT_FLOAT_EQ(3.0f, mesh.radius());
+    expect_near(glm::vec3(-1, -2, -3), mesh.bounds().min());
+    expect_near(glm::vec3(4, 5, 6), mesh.bounds().max());
+}
@@ -0,0 +1,94 @@
+#include <sigma/graphics/view_culler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(view_culler, masks_match_testing_each_view_separately)
+{
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::vector<sigma::AABB> boxes;
+    for (int i = 0; i < 5000; ++i)
+        boxes.emplace_back(glm::vec3 { position(gen), position(gen), position(gen) }, glm::vec3 { 2, 2, 2 });
+
+    sigma::bvh scene;
+    scene.build(boxes);
+
+    std::vector<sigma::frustum> views;
+    for (int i = 0; i < 12; ++i) {
+        float angle = glm::radians(30.0f * i);
+        glm::vec3 eye { 20.0f * std::cos(angle), 0, 20.0f * std::sin(angle) };
+        views.emplace_back(glm::radians(50.0f), 1.0f, 0.1f, 70.0f, glm::lookAt(eye, glm::vec3 { 0 }, glm::vec3 { 0, 1, 0 }));
+    }
+
+    sigma::graphics::view_culler culler;
+    for (const auto& view : views)
+        culler.add_view(view);
+    culler.add_view(glm::ortho(-30.0f, 30.0f, -30.0f, 30.0f, -50.0f, 50.0f));
+
+    std::vector<std::uint64_t> masks;
+    culler.cull(scene, masks);
+
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        std::uint64_t expected = 0;
+        for (std::size_t v = 0; v < views.size(); ++v) {
+            if (views[v].contains_box(boxes[i]))
+                expected |= std::uint64_t(1) << v;
+        }
+        glm::vec3 min = boxes[i].min(), max = boxes[i].max();
+        if (min.x <= 30 && max.x >= -30 && min.y <= 30 && max.y >= -30 && min.z <= 50 && max.z >= -50)
+            expected |= std::uint64_t(1) << views.size();
+
+        EXPECT_EQ(expected, masks[i]) << "box " << i;
+    }
+
+    std::vector<std::vector<std::uint32_t>> draw_lists;
+    culler.build_draw_lists(masks, draw_lists);
+    ASSERT_EQ(views.size() + 1, draw_lists.size());
+    for (std::size_t v = 0; v < draw_lists.size(); ++v) {
+        std::vector<std::uint32_t> expected;
+        culler.build_draw_list(masks, v, expected);
+        EXPECT_EQ(expected, draw_lists[v]);
+    }
+}
+
+TEST(view_culler, frame_memory_output_matches_heap_output)
+{
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::vector<sigma::AABB> boxes;
+    for (int i = 0; i < 1000; ++i)
+        boxes.emplace_back(glm::vec3 { position(gen), position(gen), position(gen) }, glm::vec3 { 1, 1, 1 });
+
+    sigma::bvh scene;
+    scene.build(boxes);
+
+    sigma::graphics::view_culler culler;
+    culler.add_view(glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 40.0f));
+    culler.add_view(glm::ortho(-20.0f, 20.0f, -20.0f, 20.0f, -20.0f, 20.0f));
+
+    std::vector<std::uint64_t> masks;
+    std::vector<std::vector<std::uint32_t>> draw_lists;
+    culler.cull(scene, masks);
+    culler.build_draw_lists(masks, draw_lists);
+
+    sigma::frame_allocator frames;
+    std::vector<sigma::frame_vector<std::uint32_t>> frame_lists;
+    for (int frame = 0; frame < 5; ++frame) {
+        frames.begin_frame();
+        sigma::frame_vector<std::uint64_t> frame_masks { sigma::arena_allocator<std::uint64_t> { frames } };
+        culler.cull(scene, frame_masks);
+        culler.build_draw_lists(frame_masks, frame_lists);
+
+        ASSERT_TRUE(std::equal(masks.begin(), masks.end(), frame_masks.begin(), frame_masks.end()));
+        ASSERT_EQ(draw_lists.size(), frame_lists.size());
+        for (std::size_t v = 0; v < draw_lists.size(); ++v)
+            EXPECT_TRUE(std::equal(draw_lists[v].begin(), draw_lists[v].end(), frame_lists[v].begin(), frame_lists[v].end()));
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef SIGMA_TEST_RANDOM_BOXES_HPP
+#define SIGMA_TEST_RANDOM_BOXES_HPP
+
+#include <sigma/AABB.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace sigma {
+namespace test {
+    // Boxes centred in [-extent, extent] on every axis with sizes in
+    // [min_size, max_size].
+    inline std::vector<AABB> random_boxes(std::size_t count, std::uint32_t seed, float extent, float min_size, float max_size)
+    {
+        std::mt19937 rng { seed };
+        std::uniform_real_distribution<float> position { -extent, extent };
+        std::uniform_real_distribution<float> size { min_size, max_size };
+
+        std::vector<AABB> boxes;
+        for (std::size_t i = 0; i < count; ++i)
+            boxes.emplace_back(glm::vec3 { position(rng), position(rng), position(rng) }, glm::vec3 { size(rng), size(rng), size(rng) });
+        return boxes;
+    }
+}
+}
+
+#endif // SIGMA_TEST_RANDOM_BOXES_HPP
@@ -0,0 +1,135 @@
+#include <sigma/spatial_hash.hpp>
+
+#include "random_boxes.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+template <class Query>
+std::vector<std::uint32_t> collect(const sigma::spatial_hash& grid, const Query& query)
+{
+    std::vector<std::uint32_t> found;
+    grid.query(query, [&](std::uint32_t id) { found.push_back(id); });
+    std::sort(found.begin(), found.end());
+    return found;
+}
+}
+
+TEST(spatial_hash, box_query_finds_objects_overhanging_their_cell)
+{
+    sigma::spatial_hash grid { 4.0f };
+    grid.insert(0, sigma::AABB { { 1, 1, 1 }, { 20, 1, 1 } });
+
+    auto found = collect(grid, sigma::AABB { { 10, 1, 1 }, { 0.5f, 0.5f, 0.5f } });
+
+    ASSERT_EQ(1, found.size());
+    EXPECT_EQ(0, found[0]);
+}
+
+TEST(spatial_hash, box_query_matches_brute_force_after_moves)
+{
+    auto boxes = sigma::test::random_boxes(2000, 7, 100.0f, 0.1f, 12.0f);
+    sigma::spatial_hash grid { 8.0f };
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+        grid.insert(i, boxes[i]);
+
+    auto moved = sigma::test::random_boxes(boxes.size() / 2, 8, 100.0f, 0.1f, 12.0f);
+    for (std::uint32_t i = 0; i < moved.size(); ++i) {
+        boxes[2 * i] = moved[i];
+        grid.update(2 * i, moved[i]);
+    }
+
+    sigma::AABB query { { 0, 0, 0 }, { 50, 30, 70 } };
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i) {
+        if (query.collides(boxes[i]))
+            expected.push_back(i);
+    }
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, collect(grid, query));
+}
+
+TEST(spatial_hash, frustum_query_matches_brute_force)
+{
+    auto boxes = sigma::test::random_boxes(2000, 9, 100.0f, 0.1f, 12.0f);
+    sigma::spatial_hash grid { 8.0f };
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+        grid.insert(i, boxes[i]);
+
+    sigma::frustum view { glm::radians(45.0f), 1.5f, 0.1f, 60.0f, glm::lookAt(glm::vec3 { 10, 0, 0 }, glm::vec3 { 0, 0, -10 }, glm::vec3 { 0, 1, 0 }) };
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i) {
+        if (view.contains_box(boxes[i]))
+            expected.push_back(i);
+    }
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, collect(grid, view));
+}
+
+TEST(spatial_hash, sphere_query_ignores_boxes_outside_radius)
+{
+    sigma::spatial_hash grid { 2.0f };
+    grid.insert(0, sigma::AABB { { 0, 0, 0 }, { 1, 1, 1 } });
+    grid.insert(1, sigma::AABB { { 3, 0, 0 }, { 1, 1, 1 } });
+    grid.insert(2, sigma::AABB { { 3, 3, 0 }, { 1, 1, 1 } });
+
+    std::vector<std::uint32_t> found;
+    grid.query(glm::vec3 { 0, 0, 0 }, 2.6f, [&](std::uint32_t id) { found.push_back(id); });
+    std::sort(found.begin(), found.end());
+
+    EXPECT_EQ((std::vector<std::uint32_t> { 0, 1 }), found);
+}
+
+TEST(spatial_hash, removed_objects_are_not_returned)
+{
+    sigma::spatial_hash grid;
+    grid.insert(3, sigma::AABB { { 0, 0, 0 }, { 1, 1, 1 } });
+    grid.insert(5, sigma::AABB { { 0, 0, 0 }, { 1, 1, 1 } });
+    grid.remove(3);
+
+    EXPECT_FALSE(grid.contains(3));
+    EXPECT_EQ(1, grid.size());
+    EXPECT_EQ((std::vector<std::uint32_t> { 5 }), collect(grid, sigma::AABB { { 0, 0, 0 }, { 1, 1, 1 } }));
+}
+
+TEST(spatial_hash, empty_cells_are_recycled)
+{
+    sigma::spatial_hash grid { 1.0f };
+    grid.insert(0, sigma::AABB { { 0.5f, 0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f } });
+    grid.insert(1, sigma::AABB { { -10.5f, 0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f } });
+    for (int i = 1; i < 1000; ++i)
+        grid.update(0, sigma::AABB { { i + 0.5f, 0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f } });
+
+    EXPECT_EQ(2u, grid.cell_count());
+    EXPECT_EQ((std::vector<std::uint32_t> { 0 }), collect(grid, sigma::AABB { { 999.5f, 0.5f, 0.5f }, { 0.1f, 0.1f, 0.1f } }));
+    EXPECT_TRUE(collect(grid, sigma::AABB { { 500.5f, 0.5f, 0.5f }, { 0.1f, 0.1f, 0.1f } }).empty());
+
+    grid.remove(1);
+    EXPECT_EQ(1u, grid.cell_count());
+}
+
+TEST(spatial_hash, loose_bounds_shrink_when_large_objects_leave)
+{
+    sigma::spatial_hash grid { 4.0f };
+    grid.insert(0, sigma::AABB { { 0, 0, 0 }, { 2, 2, 2 } });
+    grid.insert(1, sigma::AABB { { 10, 0, 0 }, { 40, 2, 2 } });
+    grid.insert(2, sigma::AABB { { 20, 0, 0 }, { 40, 2, 2 } });
+    EXPECT_EQ(glm::vec3(20, 1, 1), grid.loose());
+
+    grid.remove(1);
+    EXPECT_EQ(glm::vec3(20, 1, 1), grid.loose());
+
+    grid.update(2, sigma::AABB { { 20, 0, 0 }, { 4, 2, 2 } });
+    EXPECT_EQ(glm::vec3(2, 1, 1), grid.loose());
+
+    grid.remove(2);
+    EXPECT_EQ(glm::vec3(1, 1, 1), grid.loose());
+}
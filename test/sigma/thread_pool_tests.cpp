@@ -0,0 +1,78 @@
+#include <sigma/util/parallel.hpp>
+#include <sigma/util/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(thread_pool, runs_job_once_per_worker)
+{
+    sigma::util::thread_pool pool { 4 };
+    std::vector<std::atomic<int>> calls(pool.size());
+    pool.run(pool.size(), [&](std::size_t worker) { calls[worker]++; });
+    for (const auto& count : calls)
+        EXPECT_EQ(1, count.load());
+}
+
+TEST(thread_pool, reuses_threads_across_runs)
+{
+    sigma::util::thread_pool pool { 4 };
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    for (int i = 0; i < 16; ++i) {
+        pool.run(pool.size(), [&](std::size_t) {
+            std::lock_guard<std::mutex> lock { mutex };
+            ids.insert(std::this_thread::get_id());
+        });
+    }
+    EXPECT_LE(ids.size(), pool.size());
+}
+
+TEST(thread_pool, nested_run_keeps_worker_index)
+{
+    sigma::util::thread_pool pool { 4 };
+    std::vector<std::atomic<int>> mismatches(pool.size());
+    pool.run(pool.size(), [&](std::size_t outer) {
+        pool.run(pool.size(), [&](std::size_t inner) {
+            if (inner != outer)
+                mismatches[outer]++;
+        });
+    });
+    for (const auto& count : mismatches)
+        EXPECT_EQ(0, count.load());
+}
+
+TEST(thread_pool, rethrows_worker_exception)
+{
+    sigma::util::thread_pool pool { 4 };
+    EXPECT_THROW(pool.run(pool.size(), [&](std::size_t worker) {
+        if (worker == pool.size() - 1)
+            throw std::runtime_error { "worker failed" };
+    }),
+        std::runtime_error);
+
+    std::atomic<int> calls { 0 };
+    pool.run(pool.size(), [&](std::size_t) { calls++; });
+    EXPECT_EQ(static_cast<int>(pool.size()), calls.load());
+}
+
+TEST(parallel_for, visits_every_index_once_including_nested)
+{
+    const std::size_t count = 64;
+    std::vector<std::atomic<int>> visits(count * count);
+    sigma::util::parallel_for(count, 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            sigma::util::parallel_for(count, 4, [&](std::size_t inner_begin, std::size_t inner_end) {
+                for (std::size_t j = inner_begin; j < inner_end; ++j)
+                    visits[i * count + j]++;
+            });
+        }
+    });
+    for (const auto& visit : visits)
+        EXPECT_EQ(1, visit.load());
+}
@@ -0,0 +1,61 @@
+#include <sigma/transform_store.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+sigma::transform random_transform(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> value { -1.0f, 1.0f };
+    glm::quat rotation = glm::normalize(glm::quat { value(rng), value(rng), value(rng), value(rng) });
+    return { { value(rng) * 10.0f, value(rng) * 10.0f, value(rng) * 10.0f }, rotation, { value(rng) + 2.0f, value(rng) + 2.0f, value(rng) + 2.0f } };
+}
+
+void expect_near(const glm::mat4& expected, const glm::mat4& actual)
+{
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r)
+            EXPECT_NEAR(expected[c][r], actual[c][r], 1e-4f);
+    }
+}
+}
+
+TEST(transform_store, compose_matches_get_matrix)
+{
+    std::mt19937 rng { 9 };
+    sigma::transform_store store;
+    std::vector<sigma::transform> transforms;
+    for (std::uint32_t i = 0; i < 1003; ++i) {
+        transforms.push_back(random_transform(rng));
+        store.insert(i, transforms.back());
+    }
+
+    store.compose();
+    for (std::uint32_t i = 0; i < transforms.size(); ++i)
+        expect_near(transforms[i].get_matrix(), sigma::affine::to_mat4(store.matrix(i)));
+}
+
+TEST(transform_store, remove_keeps_other_entities)
+{
+    std::mt19937 rng { 2 };
+    sigma::transform_store store;
+    std::vector<sigma::transform> transforms;
+    for (std::uint32_t i = 0; i < 10; ++i) {
+        transforms.push_back(random_transform(rng));
+        store.insert(i, transforms.back());
+    }
+
+    store.remove(3);
+    store.remove(9);
+    store.set_position(4, { 1, 2, 3 });
+    transforms[4].position = { 1, 2, 3 };
+    store.compose();
+
+    EXPECT_EQ(8u, store.size());
+    EXPECT_FALSE(store.contains(3));
+    for (std::uint32_t i = 0; i < 9; ++i) {
+        if (i != 3)
+            expect_near(transforms[i].get_matrix(), sigma::affine::to_mat4(store.matrix(i)));
+    }
+}
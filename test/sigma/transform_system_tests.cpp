@@ -0,0 +1,160 @@
+#include <sigma/transform_system.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace {
+bool contains(const std::vector<sigma::transform_system::entity_type>& entities, sigma::transform_system::entity_type entity)
+{
+    return std::find(entities.begin(), entities.end(), entity) != entities.end();
+}
+
+void expect_translation(const glm::vec3& expected, const sigma::affine::matrix& matrix)
+{
+    EXPECT_FLOAT_EQ(expected.x, sigma::affine::translation(matrix).x);
+    EXPECT_FLOAT_EQ(expected.y, sigma::affine::translation(matrix).y);
+    EXPECT_FLOAT_EQ(expected.z, sigma::affine::translation(matrix).z);
+}
+}
+
+TEST(transform_system, children_follow_their_parents)
+{
+    entt::registry<> registry;
+    sigma::transform_system system;
+
+    auto root = registry.create();
+    auto child = registry.create();
+    auto grandchild = registry.create();
+    registry.assign<sigma::transform>(root, glm::vec3 { 1, 0, 0 });
+    registry.assign<sigma::transform>(child, glm::vec3 { 0, 2, 0 });
+    registry.assign<sigma::transform>(grandchild, glm::vec3 { 0, 0, 3 });
+    system.set_parent(registry, grandchild, child);
+    system.set_parent(registry, child, root);
+
+    system.update(registry);
+    expect_translation({ 1, 2, 3 }, registry.get<sigma::transform>(grandchild).matrix);
+    EXPECT_EQ(2u, registry.get<sigma::hierarchy>(grandchild).depth);
+    EXPECT_EQ(3u, system.changed().size());
+
+    registry.get<sigma::transform>(root).position = { 5, 0, 0 };
+    registry.get<sigma::transform>(root).dirty = true;
+    system.update(registry);
+    expect_translation({ 5, 2, 3 }, registry.get<sigma::transform>(grandchild).matrix);
+    EXPECT_EQ(3u, system.changed().size());
+}
+
+TEST(transform_system, only_dirty_subtrees_are_updated)
+{
+    entt::registry<> registry;
+    sigma::transform_system system;
+
+    auto a = registry.create();
+    auto a_child = registry.create();
+    auto b = registry.create();
+    auto b_child = registry.create();
+    for (auto e : { a, a_child, b, b_child })
+        registry.assign<sigma::transform>(e);
+    system.set_parent(registry, a_child, a);
+    system.set_parent(registry, b_child, b);
+    system.update(registry);
+
+    system.update(registry);
+    EXPECT_TRUE(system.changed().empty());
+
+    registry.get<sigma::transform>(b).dirty = true;
+    system.update(registry);
+    EXPECT_EQ(2u, system.changed().size());
+    EXPECT_TRUE(contains(system.changed(), b));
+    EXPECT_TRUE(contains(system.changed(), b_child));
+}
+
+TEST(transform_system, reparenting_moves_the_subtree)
+{
+    entt::registry<> registry;
+    sigma::transform_system system;
+
+    auto a = registry.create();
+    auto b = registry.create();
+    auto child = registry.create();
+    registry.assign<sigma::transform>(a, glm::vec3 { 1, 0, 0 });
+    registry.assign<sigma::transform>(b, glm::vec3 { -1, 0, 0 });
+    registry.assign<sigma::transform>(child, glm::vec3 { 0, 1, 0 });
+    system.set_parent(registry, child, a);
+    system.update(registry);
+    expect_translation({ 1, 1, 0 }, registry.get<sigma::transform>(child).matrix);
+
+    system.set_parent(registry, child, b);
+    system.update(registry);
+    expect_translation({ -1, 1, 0 }, registry.get<sigma::transform>(child).matrix);
+
+    system.remove_parent(registry, child);
+    system.update(registry);
+    expect_translation({ 0, 1, 0 }, registry.get<sigma::transform>(child).matrix);
+}
+
+TEST(transform_system, cycles_are_rejected)
+{
+    entt::registry<> registry;
+    sigma::transform_system system;
+
+    auto a = registry.create();
+    auto b = registry.create();
+    system.set_parent(registry, b, a);
+    EXPECT_THROW(system.set_parent(registry, a, b), std::invalid_argument);
+    EXPECT_THROW(system.set_parent(registry, a, a), std::invalid_argument);
+}
+
+TEST(transform_system, wide_subtrees_are_updated)
+{
+    entt::registry<> registry;
+    sigma::transform_system system;
+
+    auto root = registry.create();
+    registry.assign<sigma::transform>(root, glm::vec3 { 0, 10, 0 });
+    std::vector<sigma::transform_system::entity_type> children;
+    for (int i = 0; i < 5000; ++i) {
+        auto child = registry.create();
+        registry.assign<sigma::transform>(child, glm::vec3 { float(i), 0, 0 });
+        system.set_parent(registry, child, root);
+        children.push_back(child);
+    }
+
+    system.update(registry);
+    EXPECT_EQ(5001u, system.changed().size());
+    for (int i = 0; i < 5000; ++i)
+        expect_translation({ float(i), 10, 0 }, registry.get<sigma::transform>(children[i]).matrix);
+}
+
+TEST(transform_system, independent_dirty_roots_are_updated_once)
+{
+    entt::registry<> registry;
+    sigma::transform_system system;
+
+    std::vector<sigma::transform_system::entity_type> roots;
+    std::vector<sigma::transform_system::entity_type> children;
+    for (int i = 0; i < 200; ++i) {
+        auto root = registry.create();
+        auto child = registry.create();
+        registry.assign<sigma::transform>(root, glm::vec3 { float(i), 0, 0 });
+        registry.assign<sigma::transform>(child, glm::vec3 { 0, 1, 0 });
+        system.set_parent(registry, child, root);
+        roots.push_back(root);
+        children.push_back(child);
+    }
+    system.update(registry);
+
+    for (int i = 0; i < 200; i += 2) {
+        registry.get<sigma::transform>(roots[i]).position.z = 5;
+        registry.get<sigma::transform>(roots[i]).dirty = true;
+        registry.get<sigma::transform>(children[i]).dirty = true;
+    }
+    system.update(registry);
+
+    EXPECT_EQ(200u, system.changed().size());
+    for (int i = 0; i < 200; ++i)
+        expect_translation({ float(i), 1, i % 2 == 0 ? 5.0f : 0.0f }, registry.get<sigma::transform>(children[i]).matrix);
+
+    system.update(registry);
+    EXPECT_TRUE(system.changed().empty());
+}